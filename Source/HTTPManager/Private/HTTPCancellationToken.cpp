@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPCancellationToken.h"
+#include "HTTPRequestQueue.h"
+
+#include "HAL/PlatformTime.h"
+
+TSharedRef<FHTTPCancellationToken> FHTTPCancellationToken::Create(float Timeout)
+{
+	TSharedRef<FHTTPCancellationToken> Token = MakeShareable(new FHTTPCancellationToken());
+	if (Timeout > 0.0f)
+	{
+		Token->Deadline = FPlatformTime::Seconds() + Timeout;
+	}
+
+	return Token;
+}
+
+TSharedRef<FHTTPCancellationToken> FHTTPCancellationToken::CreateChild(float Timeout)
+{
+	TSharedRef<FHTTPCancellationToken> Child = Create(Timeout);
+	Child->Parent = AsShared();
+	return Child;
+}
+
+void FHTTPCancellationToken::Cancel()
+{
+	if (bIsCancelled)
+	{
+		return;
+	}
+
+	bIsCancelled = true;
+	FHTTPRequestQueue::Get().CancelByToken(*this);
+}
+
+bool FHTTPCancellationToken::IsCancelled() const
+{
+	return bIsCancelled || (Parent.IsValid() && Parent->IsCancelled());
+}
+
+double FHTTPCancellationToken::GetDeadline() const
+{
+	return Parent.IsValid() ? FMath::Min(Deadline, Parent->GetDeadline()) : Deadline;
+}
+
+bool FHTTPCancellationToken::IsChildOf(const FHTTPCancellationToken& Ancestor) const
+{
+	for (const FHTTPCancellationToken* Token = this; Token != nullptr; Token = Token->Parent.Get())
+	{
+		if (Token == &Ancestor)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
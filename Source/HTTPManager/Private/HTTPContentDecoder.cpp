@@ -0,0 +1,217 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPContentDecoder.h"
+
+#include "Misc/Paths.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace HTTPContentDecoder
+{
+	static const int32 OutputBlockSize = 64 * 1024;
+
+	// 15 window bits + 32 - zlib detects the gzip or zlib wrapper by itself
+	static const int32 AutoDetectWindowBits = 15 + 32;
+
+	// Negative window bits - no wrapper at all
+	static const int32 RawDeflateWindowBits = -15;
+}
+
+FHTTPContentDecoder::FHTTPContentDecoder(bool bInIsRawDeflate)
+	: Stream(MakeUnique<z_stream_s>())
+	, bIsRawDeflate(bInIsRawDeflate)
+{
+	FMemory::Memzero(Stream.Get(), sizeof(z_stream_s));
+	OutputBuffer.SetNumUninitialized(HTTPContentDecoder::OutputBlockSize);
+	const int32 WindowBits = bIsRawDeflate ? HTTPContentDecoder::RawDeflateWindowBits : HTTPContentDecoder::AutoDetectWindowBits;
+	bIsInitialized = inflateInit2(Stream.Get(), WindowBits) == Z_OK;
+}
+
+FHTTPContentDecoder::~FHTTPContentDecoder()
+{
+	if (bIsInitialized)
+	{
+		inflateEnd(Stream.Get());
+	}
+}
+
+bool FHTTPContentDecoder::IsCompressed(const uint8* Data, int64 Num)
+{
+	if (Num < MinSniffSize)
+	{
+		return false;
+	}
+
+	// gzip member
+	if (Data[0] == 0x1f && Data[1] == 0x8b)
+	{
+		return true;
+	}
+
+	// zlib - deflate method, window <= 32K, header checksum, no preset dictionary
+	const bool bIsDeflate = (Data[0] & 0x0f) == 8 && (Data[0] >> 4) <= 7;
+	const bool bIsChecksumValid = ((Data[0] << 8) | Data[1]) % 31 == 0;
+	const bool bHasDictionary = (Data[1] & 0x20) != 0;
+	return bIsDeflate && bIsChecksumValid && !bHasDictionary;
+}
+
+bool FHTTPContentDecoder::Decode(const uint8* Data, int64 Num, FSinkFunc Sink, int64* OutConsumed)
+{
+	const int64 TotalNum = Num;
+	const bool bIsDecoded = DecodeInternal(Data, Num, Sink);
+
+	if (OutConsumed != nullptr)
+	{
+		*OutConsumed = TotalNum - Num;
+	}
+	return bIsDecoded;
+}
+
+bool FHTTPContentDecoder::DecodeInternal(const uint8*& Data, int64& Num, FSinkFunc Sink)
+{
+	if (!bIsInitialized)
+	{
+		return false;
+	}
+
+	while (Num > 0)
+	{
+		// Concatenated gzip members - start over for the next one
+		if (bIsFinished)
+		{
+			// A deflate stream has no successor - whatever follows isn't ours
+			if (bIsRawDeflate)
+			{
+				return true;
+			}
+
+			if (inflateReset(Stream.Get()) != Z_OK)
+			{
+				return false;
+			}
+			bIsFinished = false;
+		}
+
+		const uInt ChunkSize = static_cast<uInt>(FMath::Min<int64>(Num, MAX_uint32));
+		Stream->next_in = const_cast<Bytef*>(Data);
+		Stream->avail_in = ChunkSize;
+
+		do
+		{
+			Stream->next_out = OutputBuffer.GetData();
+			Stream->avail_out = OutputBuffer.Num();
+
+			const int32 Result = inflate(Stream.Get(), Z_NO_FLUSH);
+			if (Result != Z_OK && Result != Z_STREAM_END && Result != Z_BUF_ERROR)
+			{
+				UE_LOG(LogTemp, Error, TEXT("FHTTPContentDecoder::Inflate failed (%d): %hs"), Result, Stream->msg != nullptr ? Stream->msg : "");
+				return false;
+			}
+
+			const int64 Decoded = OutputBuffer.Num() - Stream->avail_out;
+			if (Decoded > 0 && !Sink(OutputBuffer.GetData(), Decoded))
+			{
+				return false;
+			}
+
+			if (Result == Z_STREAM_END)
+			{
+				bIsFinished = true;
+				break;
+			}
+		}
+		while (Stream->avail_out == 0);
+
+		const int64 Consumed = ChunkSize - Stream->avail_in;
+		Data += Consumed;
+		Num -= Consumed;
+
+		// Trailing garbage after the last member that isn't another gzip header
+		if (bIsFinished && Num > 0 && !bIsRawDeflate && !IsCompressed(Data, Num))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FHTTPContentDecoder::Ignoring %lld bytes after the end of the compressed body."), Num);
+			return true;
+		}
+
+		// No progress - inflate waits for more input
+		if (!bIsFinished && Consumed == 0)
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool FHTTPContentDecoder::DecodeBody(const TArray<uint8>& Body, bool bIsEncoded, TArray<uint8>& OutBody)
+{
+	if (!bIsEncoded || !IsCompressed(Body.GetData(), Body.Num()))
+	{
+		OutBody = Body;
+		return true;
+	}
+
+	TArray<uint8> Decoded;
+	Decoded.Reserve(Body.Num() * 4);
+
+	FHTTPContentDecoder Decoder;
+	const bool bIsDecoded = Decoder.Decode(Body.GetData(), Body.Num(), [&Decoded](const uint8* Data, int64 Num)
+	{
+		if (Decoded.Num() + Num > MAX_int32)
+		{
+			return false;
+		}
+		Decoded.Append(Data, static_cast<int32>(Num));
+		return true;
+	});
+
+	if (!bIsDecoded || !Decoder.IsFinished())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPContentDecoder::Compressed body is truncated or corrupted."));
+		return false;
+	}
+
+	OutBody = MoveTemp(Decoded);
+	return true;
+}
+
+bool FHTTPContentDecoder::IsContentEncoded(const FString& ContentEncoding)
+{
+	// x-gzip is the legacy spelling - identity and unknown codings are never inflated
+	FString Coding = ContentEncoding.TrimStartAndEnd();
+	return Coding.Equals(TEXT("gzip"), ESearchCase::IgnoreCase)
+		|| Coding.Equals(TEXT("x-gzip"), ESearchCase::IgnoreCase)
+		|| Coding.Equals(TEXT("deflate"), ESearchCase::IgnoreCase);
+}
+
+bool FHTTPContentDecoder::IsContentEncoded(const FHttpResponsePtr& Response)
+{
+	return Response.IsValid() && IsContentEncoded(Response->GetHeader(TEXT("Content-Encoding")));
+}
+
+bool FHTTPContentDecoder::ShouldDecode(const FString& URL)
+{
+	// A .gz download is the payload itself - inflating it would hand over something else than what was asked for
+	FString Path;
+	if (!URL.Split(TEXT("?"), &Path, nullptr))
+	{
+		Path = URL;
+	}
+
+	const FString Extension = FPaths::GetExtension(Path).ToLower();
+	return Extension != TEXT("gz") && Extension != TEXT("tgz") && Extension != TEXT("svgz");
+}
+
+bool FHTTPContentDecoder::ApplyAcceptEncoding(const FString& URL, const FHttpRequestRef& Request)
+{
+	if (!ShouldDecode(URL))
+	{
+		return false;
+	}
+
+	Request->SetHeader(TEXT("Accept-Encoding"), TEXT("gzip, deflate"));
+	return true;
+}
@@ -0,0 +1,242 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPMetrics.h"
+
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "PlatformHttp.h"
+
+namespace HTTPMetrics
+{
+	// Lower bound of the first bucket in seconds - every bucket is 2^(1/8) wider than the previous one
+	constexpr double BucketBase = 0.0001;
+	constexpr double BucketsPerOctave = 8.0;
+	constexpr int32 NumBuckets = 192;
+
+	const TCHAR* GetPhaseName(int32 Phase)
+	{
+		static const TCHAR* Names[] = { TEXT("Queue"), TEXT("TimeToFirstByte"), TEXT("Transfer"), TEXT("Process"), TEXT("Worker"), TEXT("Total") };
+		return Names[Phase];
+	}
+
+	bool IsIdSegment(const FString& Segment)
+	{
+		if (Segment.IsEmpty())
+		{
+			return false;
+		}
+
+		bool bIsNumber = true;
+		bool bIsHex = Segment.Len() >= 7;
+		for (const TCHAR Char : Segment)
+		{
+			bIsNumber &= FChar::IsDigit(Char);
+			bIsHex &= FChar::IsHexDigit(Char);
+		}
+
+		return bIsNumber || bIsHex;
+	}
+}
+
+FHTTPMetrics& FHTTPMetrics::Get()
+{
+	static FHTTPMetrics Instance;
+	return Instance;
+}
+
+void FHTTPMetrics::FHistogram::Add(double Seconds)
+{
+	Seconds = FMath::Max(Seconds, 0.0);
+
+	if (Buckets.IsEmpty())
+	{
+		Buckets.SetNumZeroed(HTTPMetrics::NumBuckets);
+	}
+
+	const double Octaves = Seconds > HTTPMetrics::BucketBase ? FMath::Log2(Seconds / HTTPMetrics::BucketBase) : 0.0;
+	const int32 Index = FMath::Clamp(FMath::FloorToInt32(Octaves * HTTPMetrics::BucketsPerOctave), 0, HTTPMetrics::NumBuckets - 1);
+	Buckets[Index]++;
+
+	Count++;
+	Sum += Seconds;
+	Min = FMath::Min(Min, Seconds);
+	Max = FMath::Max(Max, Seconds);
+}
+
+double FHTTPMetrics::FHistogram::GetPercentile(double Percentile) const
+{
+	if (Count == 0)
+	{
+		return 0.0;
+	}
+
+	const int64 Rank = FMath::Max<int64>(FMath::CeilToInt64(Percentile * Count), 1);
+
+	int64 Seen = 0;
+	for (int32 Index = 0; Index < Buckets.Num(); ++Index)
+	{
+		Seen += Buckets[Index];
+		if (Seen >= Rank)
+		{
+			const double Midpoint = HTTPMetrics::BucketBase * FMath::Pow(2.0, (Index + 0.5) / HTTPMetrics::BucketsPerOctave);
+			return FMath::Clamp(Midpoint, Min, Max);
+		}
+	}
+
+	return Max;
+}
+
+void FHTTPMetrics::RecordRequest(const FString& URL, const FString& Host, const FHTTPRequestTimings& Timings)
+{
+	check(IsInGameThread());
+
+	RecordSeries(Host, Timings);
+	RecordSeries(Host + GetEndpoint(URL), Timings);
+}
+
+void FHTTPMetrics::RecordWorker(const FString& URL, double Seconds)
+{
+	AsyncTask(ENamedThreads::GameThread, [this, URL, Seconds]()
+	{
+		const FString Host = FPlatformHttp::GetUrlDomain(URL);
+		Series.FindOrAdd(Host).Phases[static_cast<int32>(EHTTPTimingPhase::Worker)].Add(Seconds);
+		Series.FindOrAdd(Host + GetEndpoint(URL)).Phases[static_cast<int32>(EHTTPTimingPhase::Worker)].Add(Seconds);
+	});
+}
+
+void FHTTPMetrics::RecordSeries(const FString& Key, const FHTTPRequestTimings& Timings)
+{
+	FSeries& Entry = Series.FindOrAdd(Key);
+	auto Phase = [&Entry](EHTTPTimingPhase InPhase) -> FHistogram& { return Entry.Phases[static_cast<int32>(InPhase)]; };
+
+	if (!Timings.bWasSuccessful)
+	{
+		Entry.Failures++;
+	}
+
+	if (Timings.FirstSendTime > 0.0)
+	{
+		Phase(EHTTPTimingPhase::Queue).Add(Timings.FirstSendTime - Timings.EnqueueTime);
+	}
+
+	// Only attempts that got an answer have a first byte
+	if (Timings.FirstByteTime > 0.0 && Timings.SendTime > 0.0)
+	{
+		Phase(EHTTPTimingPhase::TimeToFirstByte).Add(Timings.FirstByteTime - Timings.SendTime);
+		Phase(EHTTPTimingPhase::Transfer).Add(Timings.CompleteTime - Timings.FirstByteTime);
+	}
+
+	Phase(EHTTPTimingPhase::Process).Add(Timings.ProcessSeconds);
+	Phase(EHTTPTimingPhase::Total).Add(Timings.CompleteTime + Timings.ProcessSeconds - Timings.EnqueueTime);
+}
+
+bool FHTTPMetrics::GetStats(const FString& Key, EHTTPTimingPhase Phase, FHTTPTimingStats& OutStats) const
+{
+	OutStats = FHTTPTimingStats();
+
+	const FSeries* Found = Series.Find(Key);
+	if (Found == nullptr)
+	{
+		return false;
+	}
+
+	const FHistogram& Histogram = Found->Phases[static_cast<int32>(Phase)];
+	if (Histogram.Count == 0)
+	{
+		return false;
+	}
+
+	OutStats.Count = static_cast<int32>(FMath::Min<int64>(Histogram.Count, MAX_int32));
+	OutStats.Min = static_cast<float>(Histogram.Min * 1000.0);
+	OutStats.Avg = static_cast<float>(Histogram.Sum / Histogram.Count * 1000.0);
+	OutStats.P50 = static_cast<float>(Histogram.GetPercentile(0.50) * 1000.0);
+	OutStats.P95 = static_cast<float>(Histogram.GetPercentile(0.95) * 1000.0);
+	OutStats.P99 = static_cast<float>(Histogram.GetPercentile(0.99) * 1000.0);
+	OutStats.Max = static_cast<float>(Histogram.Max * 1000.0);
+	return true;
+}
+
+TArray<FString> FHTTPMetrics::GetKeys() const
+{
+	TArray<FString> Keys;
+	Series.GetKeys(Keys);
+	Keys.Sort();
+	return Keys;
+}
+
+FString FHTTPMetrics::ToCSV() const
+{
+	FString CSV = TEXT("Key,Phase,Count,Failures,MinMs,AvgMs,P50Ms,P95Ms,P99Ms,MaxMs\n");
+
+	for (const FString& Key : GetKeys())
+	{
+		const FSeries& Entry = Series.FindChecked(Key);
+		for (int32 Phase = 0; Phase <= static_cast<int32>(EHTTPTimingPhase::Total); ++Phase)
+		{
+			FHTTPTimingStats Stats;
+			if (!GetStats(Key, static_cast<EHTTPTimingPhase>(Phase), Stats))
+			{
+				continue;
+			}
+
+			CSV += FString::Printf(TEXT("\"%s\",%s,%d,%lld,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n"),
+				*Key.Replace(TEXT("\""), TEXT("\"\"")), HTTPMetrics::GetPhaseName(Phase), Stats.Count, Entry.Failures,
+				Stats.Min, Stats.Avg, Stats.P50, Stats.P95, Stats.P99, Stats.Max);
+		}
+	}
+
+	return CSV;
+}
+
+bool FHTTPMetrics::ExportCSV(const FString& FilePath) const
+{
+	if (!FFileHelper::SaveStringToFile(ToCSV(), *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPMetrics::Failed to write %s."), *FilePath);
+		return false;
+	}
+
+	return true;
+}
+
+void FHTTPMetrics::Reset()
+{
+	Series.Empty();
+}
+
+FString FHTTPMetrics::GetEndpoint(const FString& URL)
+{
+	FString Path = URL;
+
+	int32 SchemeEnd = Path.Find(TEXT("://"));
+	if (SchemeEnd != INDEX_NONE)
+	{
+		Path.RightChopInline(SchemeEnd + 3);
+	}
+
+	int32 Index = INDEX_NONE;
+	if (Path.FindChar(TEXT('?'), Index) || Path.FindChar(TEXT('#'), Index))
+	{
+		Path.LeftInline(Index);
+	}
+
+	// Drop the host
+	if (!Path.FindChar(TEXT('/'), Index))
+	{
+		return TEXT("/");
+	}
+	Path.RightChopInline(Index);
+
+	TArray<FString> Segments;
+	Path.ParseIntoArray(Segments, TEXT("/"));
+
+	FString Endpoint;
+	for (int32 SegmentIndex = 0; SegmentIndex < FMath::Min(Segments.Num(), 4); ++SegmentIndex)
+	{
+		Endpoint += TEXT("/");
+		Endpoint += HTTPMetrics::IsIdSegment(Segments[SegmentIndex]) ? TEXT(":id") : Segments[SegmentIndex];
+	}
+
+	return Endpoint.IsEmpty() ? TEXT("/") : Endpoint;
+}
@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPRateLimiter.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+
+namespace HTTPRateLimiter
+{
+	// GitHub resets its primary rate limit every hour
+	static const int64 WindowLength = 3600;
+
+	static int64 GetUnixNow()
+	{
+		return FDateTime::UtcNow().ToUnixTimestamp();
+	}
+}
+
+FHTTPRateLimiter& FHTTPRateLimiter::Get()
+{
+	static FHTTPRateLimiter Instance;
+	return Instance;
+}
+
+void FHTTPRateLimiter::Update(const FString& Host, int32 Limit, int32 Remaining, int64 ResetAt)
+{
+	if (Host.IsEmpty() || ResetAt <= HTTPRateLimiter::GetUnixNow())
+	{
+		return;
+	}
+
+	FBucket* Existing = Buckets.Find(Host);
+	FBucket& Bucket = Existing != nullptr ? *Existing : Buckets.Add(Host);
+
+	// Same window - responses of requests sent before our latest tokens were taken report a stale count, keep the lower one
+	if (Existing != nullptr && Bucket.ResetAt == ResetAt)
+	{
+		Bucket.Remaining = FMath::Min(Bucket.Remaining, Remaining);
+	}
+	else
+	{
+		Bucket.Remaining = Remaining;
+		Bucket.Tokens = FMath::Min<double>(BurstSize, Remaining);
+		Bucket.LastRefill = FPlatformTime::Seconds();
+	}
+
+	Bucket.Limit = Limit > 0 ? Limit : Bucket.Limit;
+	Bucket.ResetAt = ResetAt;
+	Bucket.Tokens = FMath::Min<double>(Bucket.Tokens, Bucket.Remaining);
+
+	OnRateLimitUpdated.Broadcast(Host, Bucket.Remaining, Bucket.ResetAt);
+}
+
+void FHTTPRateLimiter::UpdateFromResponse(const FString& Host, const FHttpResponsePtr& Response)
+{
+	if (!Response.IsValid())
+	{
+		return;
+	}
+
+	const FString Limit = Response->GetHeader(TEXT("X-RateLimit-Limit"));
+	const FString Remaining = Response->GetHeader(TEXT("X-RateLimit-Remaining"));
+	const FString Reset = Response->GetHeader(TEXT("X-RateLimit-Reset"));
+	if (!Remaining.IsNumeric() || !Reset.IsNumeric())
+	{
+		return;
+	}
+
+	Update(Host, FCString::Atoi(*Limit), FCString::Atoi(*Remaining), FCString::Atoi64(*Reset));
+}
+
+double FHTTPRateLimiter::GetRefillRate(const FBucket& Bucket) const
+{
+	const int64 SecondsLeft = FMath::Max<int64>(Bucket.ResetAt - HTTPRateLimiter::GetUnixNow(), 1);
+	return static_cast<double>(Bucket.Remaining) / SecondsLeft;
+}
+
+double FHTTPRateLimiter::GetAvailableTokens(const FBucket& Bucket) const
+{
+	const double Elapsed = FPlatformTime::Seconds() - Bucket.LastRefill;
+	const double Capacity = FMath::Min<double>(BurstSize, Bucket.Remaining);
+	return FMath::Min(Bucket.Tokens + Elapsed * GetRefillRate(Bucket), Capacity);
+}
+
+bool FHTTPRateLimiter::RollWindow(FBucket& Bucket) const
+{
+	const int64 Now = HTTPRateLimiter::GetUnixNow();
+	if (Bucket.ResetAt > Now)
+	{
+		return true;
+	}
+
+	// Seeded without a limit - nothing to refill from until a response reports one
+	if (Bucket.Limit <= 0)
+	{
+		return false;
+	}
+
+	Bucket.Remaining = Bucket.Limit;
+	Bucket.ResetAt = Now + HTTPRateLimiter::WindowLength;
+	Bucket.Tokens = FMath::Min<double>(BurstSize, Bucket.Remaining);
+	Bucket.LastRefill = FPlatformTime::Seconds();
+	return true;
+}
+
+double FHTTPRateLimiter::GetWaitTime(const FString& Host, bool bIgnorePacing) const
+{
+	const FBucket* Found = Buckets.Find(Host);
+	if (Found == nullptr)
+	{
+		return 0.0;
+	}
+
+	FBucket Bucket = *Found;
+	if (!RollWindow(Bucket))
+	{
+		return 0.0;
+	}
+
+	if (GetAvailableTokens(Bucket) >= 1.0 || (bIgnorePacing && Bucket.Remaining > 0))
+	{
+		return 0.0;
+	}
+
+	// Budget spent - nothing until the window resets
+	if (Bucket.Remaining <= 0)
+	{
+		return static_cast<double>(Bucket.ResetAt - HTTPRateLimiter::GetUnixNow());
+	}
+
+	return (1.0 - GetAvailableTokens(Bucket)) / GetRefillRate(Bucket);
+}
+
+void FHTTPRateLimiter::Acquire(const FString& Host)
+{
+	FBucket* Bucket = Buckets.Find(Host);
+	if (Bucket == nullptr)
+	{
+		return;
+	}
+
+	if (!RollWindow(*Bucket))
+	{
+		Buckets.Remove(Host);
+		return;
+	}
+
+	Bucket->Tokens = FMath::Max(GetAvailableTokens(*Bucket) - 1.0, 0.0);
+	Bucket->LastRefill = FPlatformTime::Seconds();
+	Bucket->Remaining = FMath::Max(Bucket->Remaining - 1, 0);
+}
+
+bool FHTTPRateLimiter::GetBudget(const FString& Host, int32& OutRemaining, int64& OutResetAt) const
+{
+	const FBucket* Bucket = Buckets.Find(Host);
+	if (Bucket == nullptr)
+	{
+		return false;
+	}
+
+	OutRemaining = Bucket->Remaining;
+	OutResetAt = Bucket->ResetAt;
+	return true;
+}
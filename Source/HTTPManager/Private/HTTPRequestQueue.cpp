@@ -0,0 +1,850 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPRequestQueue.h"
+#include "HTTPMetrics.h"
+#include "HTTPRateLimiter.h"
+
+#include "PlatformHttp.h"
+#include "HAL/PlatformTime.h"
+#include "Templates/UnrealTemplate.h"
+
+FHTTPRequestQueue& FHTTPRequestQueue::Get()
+{
+	static FHTTPRequestQueue Instance;
+	return Instance;
+}
+
+int32 FHTTPRequestQueue::Enqueue(const FString& URL, FHTTPQueueSetupFunc OnSetup, FHTTPQueueCompleteFunc OnComplete, const FHTTPRequestOptions& Options)
+{
+	check(IsInGameThread());
+
+	const int32 RequestId = AddEntry(URL, MoveTemp(OnSetup), MoveTemp(OnComplete), Options)->RequestId;
+
+	PumpQueue();
+	return RequestId;
+}
+
+int32 FHTTPRequestQueue::EnqueueCoalesced(const FString& URL, FHTTPQueueSetupFunc OnSetup, FHTTPQueueCompleteFunc OnComplete, const FHTTPRequestOptions& Options)
+{
+	check(IsInGameThread());
+
+	// The representation belongs to the key - a SHA-only answer must never reach a caller that asked for JSON
+	const FString CoalesceKey = Options.Accept.IsEmpty() ? TEXT("GET ") + URL : FString::Printf(TEXT("GET %s Accept: %s"), *URL, *Options.Accept);
+
+	// Someone already asked for this URL - wait for the same response
+	if (const int32* LeaderId = CoalescedRequests.Find(CoalesceKey))
+	{
+		TSharedPtr<FHTTPQueuedRequest> Leader = FindEntry(*LeaderId);
+		if (Leader.IsValid() && !Leader->IsCancelled())
+		{
+			const int32 RequestId = NextRequestId++;
+
+			FHTTPQueuedFollower& Follower = Leader->Followers.AddDefaulted_GetRef();
+			Follower.RequestId = RequestId;
+			Follower.OnComplete = MoveTemp(OnComplete);
+			Follower.CancellationToken = Options.CancellationToken;
+
+			UE_LOG(LogTemp, Verbose, TEXT("FHTTPRequestQueue::Request %d joined %d for %s."), RequestId, *LeaderId, *URL);
+
+			// An interactive caller must not wait behind the background request it joined
+			if (Options.Priority > Leader->Priority)
+			{
+				Leader->Priority = Options.Priority;
+				if (Pending.Remove(Leader) > 0)
+				{
+					InsertPending(Leader, false);
+					PumpQueue();
+				}
+			}
+
+			return RequestId;
+		}
+	}
+
+	FHTTPRequestOptions GetOptions = Options;
+	GetOptions.Verb = TEXT("GET");
+	GetOptions.OnSpoolSetup = nullptr;
+
+	TSharedPtr<FHTTPQueuedRequest> Entry = AddEntry(URL, MoveTemp(OnSetup), MoveTemp(OnComplete), GetOptions);
+	Entry->CoalesceKey = CoalesceKey;
+	CoalescedRequests.Add(CoalesceKey, Entry->RequestId);
+
+	const int32 RequestId = Entry->RequestId;
+	PumpQueue();
+	return RequestId;
+}
+
+TSharedPtr<FHTTPQueuedRequest> FHTTPRequestQueue::AddEntry(const FString& URL, FHTTPQueueSetupFunc OnSetup, FHTTPQueueCompleteFunc OnComplete, const FHTTPRequestOptions& Options)
+{
+	TSharedPtr<FHTTPQueuedRequest> Entry = MakeShared<FHTTPQueuedRequest>();
+	Entry->RequestId = NextRequestId++;
+	Entry->URL = URL;
+	Entry->Verb = Options.Verb;
+	Entry->Accept = Options.Accept;
+	Entry->Host = FPlatformHttp::GetUrlDomain(URL);
+	Entry->Priority = Options.Priority;
+	Entry->ConnectTimeout = Options.ConnectTimeout < 0.0f ? DefaultConnectTimeout : Options.ConnectTimeout;
+	Entry->Timeout = Options.Timeout < 0.0f ? DefaultTimeout : Options.Timeout;
+	Entry->CancellationToken = Options.CancellationToken;
+	Entry->bBuffersBody = Options.bBuffersBody;
+	Entry->ExpectedBodySize = Options.ExpectedBodySize;
+	Entry->OnSpoolSetup = Options.OnSpoolSetup;
+	Entry->OnSetup = MoveTemp(OnSetup);
+	Entry->OnComplete = MoveTemp(OnComplete);
+	Entry->RetryPolicy = RetryPolicy;
+	Entry->EnqueueTime = FPlatformTime::Seconds();
+
+	InsertPending(Entry, false);
+	EnsureWatchdog();
+	return Entry;
+}
+
+void FHTTPRequestQueue::InsertPending(const TSharedPtr<FHTTPQueuedRequest>& Entry, bool bAtFront)
+{
+	int32 Index = 0;
+	if (bAtFront)
+	{
+		while (Index < Pending.Num() && Pending[Index]->Priority > Entry->Priority)
+		{
+			++Index;
+		}
+	}
+	else
+	{
+		Index = Pending.Num();
+		while (Index > 0 && Pending[Index - 1]->Priority < Entry->Priority)
+		{
+			--Index;
+		}
+	}
+
+	Pending.Insert(Entry, Index);
+}
+
+TSharedPtr<FHTTPQueuedRequest> FHTTPRequestQueue::FindEntry(int32 RequestId) const
+{
+	if (const TSharedPtr<FHTTPQueuedRequest>* InFlightEntry = InFlight.Find(RequestId))
+	{
+		return *InFlightEntry;
+	}
+
+	const TSharedPtr<FHTTPQueuedRequest>* PendingEntry = Pending.FindByPredicate([RequestId](const TSharedPtr<FHTTPQueuedRequest>& Entry) { return Entry->RequestId == RequestId; });
+	return PendingEntry != nullptr ? *PendingEntry : nullptr;
+}
+
+TArray<TSharedPtr<FHTTPQueuedRequest>> FHTTPRequestQueue::GetAllEntries() const
+{
+	TArray<TSharedPtr<FHTTPQueuedRequest>> Entries = Pending;
+	for (const TPair<int32, TSharedPtr<FHTTPQueuedRequest>>& Pair : InFlight)
+	{
+		Entries.Add(Pair.Value);
+	}
+
+	return Entries;
+}
+
+// Fans the response out to the request's own callback and everyone who joined it
+void FHTTPRequestQueue::CompleteEntry(const TSharedPtr<FHTTPQueuedRequest>& Entry, FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	const double CompleteTime = FPlatformTime::Seconds();
+
+	// Late callers start a fresh request from now on
+	const int32* LeaderId = CoalescedRequests.Find(Entry->CoalesceKey);
+	if (LeaderId != nullptr && *LeaderId == Entry->RequestId)
+	{
+		CoalescedRequests.Remove(Entry->CoalesceKey);
+	}
+
+	// One charge for the body, however many callers share the response
+	TSharedPtr<FHTTPBufferHold, ESPMode::ThreadSafe> BufferHold;
+	if (Response.IsValid() && Entry->bBuffersBody && !Entry->bIsSpooled)
+	{
+		BufferHold = HoldBuffer(Response->GetContent().Num());
+	}
+
+	{
+		TGuardValue<TSharedPtr<FHTTPBufferHold, ESPMode::ThreadSafe>> CompletingHoldGuard(CompletingBufferHold, BufferHold);
+
+		if (Entry->OnComplete)
+		{
+			Entry->OnComplete(Request, Response, bWasSuccessful);
+		}
+
+		for (FHTTPQueuedFollower& Follower : Entry->Followers)
+		{
+			if (Follower.OnComplete)
+			{
+				Follower.OnComplete(Request, Response, bWasSuccessful);
+			}
+		}
+	}
+
+	// Requests that never left the queue have nothing to measure
+	if (Entry->AttemptsMade == 0)
+	{
+		return;
+	}
+
+	FHTTPRequestTimings Timings;
+	Timings.EnqueueTime = Entry->EnqueueTime;
+	Timings.FirstSendTime = Entry->FirstSendTime;
+	Timings.SendTime = Entry->SendTime;
+	Timings.FirstByteTime = Entry->FirstByteTime.IsValid() ? Entry->FirstByteTime->load() : 0.0;
+	Timings.CompleteTime = CompleteTime;
+	// Only the game thread part of the callbacks - work they hand to worker tasks is reported through FHTTPMetrics::RecordWorker
+	Timings.ProcessSeconds = FPlatformTime::Seconds() - CompleteTime;
+	Timings.bWasSuccessful = bWasSuccessful && Response.IsValid() && Response->GetResponseCode() < 400;
+
+	FHTTPMetrics::Get().RecordRequest(Entry->URL, Entry->Host, Timings);
+
+	UE_LOG(LogTemp, Verbose, TEXT("FHTTPRequestQueue::Request %d took %.0fms - queue %.0fms, first byte %.0fms, process %.0fms: %s"),
+		Entry->RequestId, (CompleteTime - Timings.EnqueueTime + Timings.ProcessSeconds) * 1000.0, (Timings.FirstSendTime - Timings.EnqueueTime) * 1000.0,
+		Timings.FirstByteTime > 0.0 ? (Timings.FirstByteTime - Timings.SendTime) * 1000.0 : 0.0, Timings.ProcessSeconds * 1000.0, *Entry->URL);
+}
+
+// Completes on the next tick - callers never get their completion from inside Enqueue
+void FHTTPRequestQueue::CompleteEntryDeferred(const TSharedPtr<FHTTPQueuedRequest>& Entry, FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, Entry, Request, Response, bWasSuccessful](float DeltaTime)
+	{
+		CompleteEntry(Entry, Request, Response, bWasSuccessful);
+		PumpQueue();
+		return false;
+	}));
+}
+
+void FHTTPRequestQueue::FailDeferred(FHTTPQueueCompleteFunc OnComplete)
+{
+	if (!OnComplete)
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([OnComplete](float DeltaTime)
+	{
+		OnComplete(nullptr, nullptr, false);
+		return false;
+	}));
+}
+
+bool FHTTPRequestQueue::Cancel(int32 RequestId)
+{
+	check(IsInGameThread());
+
+	for (const TSharedPtr<FHTTPQueuedRequest>& Entry : GetAllEntries())
+	{
+		const int32 FollowerIndex = Entry->Followers.IndexOfByPredicate([RequestId](const FHTTPQueuedFollower& Follower) { return Follower.RequestId == RequestId; });
+		if (FollowerIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FailDeferred(MoveTemp(Entry->Followers[FollowerIndex].OnComplete));
+		Entry->Followers.RemoveAt(FollowerIndex);
+
+		// The last one waiting for the response left
+		if (Entry->Followers.IsEmpty() && !Entry->OnComplete)
+		{
+			CancelEntry(Entry);
+		}
+		return true;
+	}
+
+	if (TSharedPtr<FHTTPQueuedRequest> Entry = FindEntry(RequestId))
+	{
+		CancelEntry(Entry);
+		return true;
+	}
+
+	return false;
+}
+
+void FHTTPRequestQueue::CancelByToken(const FHTTPCancellationToken& Token)
+{
+	check(IsInGameThread());
+
+	auto IsCancelledBy = [&Token](const TSharedPtr<FHTTPCancellationToken>& EntryToken)
+	{
+		return EntryToken.IsValid() && EntryToken->IsChildOf(Token);
+	};
+
+	int32 NumCancelled = 0;
+	for (const TSharedPtr<FHTTPQueuedRequest>& Entry : GetAllEntries())
+	{
+		int32 NumRemoved = 0;
+		for (int32 Index = Entry->Followers.Num() - 1; Index >= 0; --Index)
+		{
+			if (IsCancelledBy(Entry->Followers[Index].CancellationToken))
+			{
+				FailDeferred(MoveTemp(Entry->Followers[Index].OnComplete));
+				Entry->Followers.RemoveAt(Index);
+				NumRemoved++;
+			}
+		}
+		NumCancelled += NumRemoved;
+
+		if (IsCancelledBy(Entry->CancellationToken) || (NumRemoved > 0 && Entry->Followers.IsEmpty() && !Entry->OnComplete))
+		{
+			CancelEntry(Entry);
+			NumCancelled++;
+		}
+	}
+
+	if (NumCancelled > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("FHTTPRequestQueue::Cancelled %d requests."), NumCancelled);
+	}
+}
+
+// Pending requests fail on the next tick, in-flight ones as soon as the HTTP module reports the cancellation
+void FHTTPRequestQueue::CancelEntry(const TSharedPtr<FHTTPQueuedRequest>& Entry)
+{
+	// Others still wait for the same response - only this caller drops out
+	if (Entry->Followers.Num() > 0)
+	{
+		FailDeferred(MoveTemp(Entry->OnComplete));
+		Entry->OnComplete = nullptr;
+		Entry->CancellationToken.Reset();
+		return;
+	}
+
+	if (Entry->bIsCancelled)
+	{
+		return;
+	}
+	Entry->bIsCancelled = true;
+
+	// Late callers must not join a request that is going away
+	const int32* LeaderId = CoalescedRequests.Find(Entry->CoalesceKey);
+	if (LeaderId != nullptr && *LeaderId == Entry->RequestId)
+	{
+		CoalescedRequests.Remove(Entry->CoalesceKey);
+	}
+
+	if (Pending.Remove(Entry) > 0)
+	{
+		CompleteEntryDeferred(Entry, nullptr, nullptr, false);
+	}
+	else if (Entry->HttpRequest.IsValid())
+	{
+		Entry->HttpRequest->CancelRequest();
+	}
+}
+
+void FHTTPRequestQueue::EnsureWatchdog()
+{
+	if (WatchdogTickerHandle.IsValid())
+	{
+		return;
+	}
+
+	WatchdogTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float DeltaTime)
+	{
+		return CheckTimeouts();
+	}), 0.25f);
+}
+
+// Returns false once the queue is empty - the watchdog is started again by the next request
+bool FHTTPRequestQueue::CheckTimeouts()
+{
+	const double Now = FPlatformTime::Seconds();
+
+	TArray<TSharedPtr<FHTTPQueuedRequest>> InFlightEntries;
+	InFlight.GenerateValueArray(InFlightEntries);
+
+	for (const TSharedPtr<FHTTPQueuedRequest>& Entry : InFlightEntries)
+	{
+		if (Entry->bIsCancelled || Entry->bIsTimedOut || !Entry->HttpRequest.IsValid())
+		{
+			continue;
+		}
+
+		const double Elapsed = Now - Entry->SendTime;
+
+		if (Now >= Entry->GetDeadline())
+		{
+			UE_LOG(LogTemp, Error, TEXT("FHTTPRequestQueue::Request %d ran past its deadline: %s"), Entry->RequestId, *Entry->URL);
+			Entry->bIsCancelled = true;
+			Entry->HttpRequest->CancelRequest();
+			continue;
+		}
+
+		// No status line yet - the connection never got established or the server doesn't answer
+		const FHttpResponsePtr Response = Entry->HttpRequest->GetResponse();
+		const bool bHasHeaders = Response.IsValid() && Response->GetResponseCode() > 0;
+
+		const bool bConnectTimedOut = Entry->ConnectTimeout > 0.0f && !bHasHeaders && Elapsed >= Entry->ConnectTimeout;
+		const bool bTimedOut = Entry->Timeout > 0.0f && Elapsed >= Entry->Timeout;
+		if (bConnectTimedOut || bTimedOut)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FHTTPRequestQueue::Request %d timed out after %.1fs (%s): %s"),
+				Entry->RequestId, Elapsed, bConnectTimedOut ? TEXT("connect") : TEXT("total"), *Entry->URL);
+			Entry->bIsTimedOut = true;
+			Entry->HttpRequest->CancelRequest();
+		}
+	}
+
+	// Expired and cancelled pending requests are failed by the pump
+	PumpQueue();
+
+	if (Pending.IsEmpty() && InFlight.IsEmpty())
+	{
+		WatchdogTickerHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void FHTTPRequestQueue::SetMaxInFlight(int32 InMaxInFlight, int32 InMaxInFlightPerHost)
+{
+	MaxInFlight = FMath::Max(1, InMaxInFlight);
+	MaxInFlightPerHost = FMath::Clamp(InMaxInFlightPerHost, 1, MaxInFlight);
+
+	// Raised limits may free slots right away
+	PumpQueue();
+}
+
+void FHTTPRequestQueue::SetReservedSlots(int32 InReservedSlots, int32 InReservedSlotsPerHost)
+{
+	ReservedSlots = FMath::Max(0, InReservedSlots);
+	ReservedSlotsPerHost = FMath::Max(0, InReservedSlotsPerHost);
+
+	PumpQueue();
+}
+
+void FHTTPRequestQueue::SetMemoryBudget(int64 InMemoryBudget)
+{
+	MemoryBudget = FMath::Max<int64>(InMemoryBudget, 0);
+
+	PumpQueue();
+}
+
+int64 FHTTPRequestQueue::GetBufferedBytes() const
+{
+	int64 BufferedBytes = HeldBytes.load();
+	for (const TPair<int32, TSharedPtr<FHTTPQueuedRequest>>& Pair : InFlight)
+	{
+		BufferedBytes += GetBufferCharge(*Pair.Value);
+	}
+
+	return BufferedBytes;
+}
+
+TSharedRef<FHTTPBufferHold, ESPMode::ThreadSafe> FHTTPRequestQueue::HoldBuffer(int64 Bytes)
+{
+	return MakeShared<FHTTPBufferHold, ESPMode::ThreadSafe>(Bytes);
+}
+
+TSharedPtr<FHTTPBufferHold, ESPMode::ThreadSafe> FHTTPRequestQueue::GetCompletingBufferHold() const
+{
+	return CompletingBufferHold;
+}
+
+FHTTPBufferHold::FHTTPBufferHold(int64 InBytes)
+	: Bytes(FMath::Max<int64>(InBytes, 0))
+{
+	FHTTPRequestQueue::Get().HeldBytes += Bytes;
+}
+
+FHTTPBufferHold::~FHTTPBufferHold()
+{
+	FHTTPRequestQueue::Get().ReleaseBuffer(Bytes);
+}
+
+// Any thread - the pump itself runs on the next core tick
+void FHTTPRequestQueue::ReleaseBuffer(int64 Bytes)
+{
+	HeldBytes -= Bytes;
+
+	if (Bytes <= 0 || bIsReleasePumpScheduled.exchange(true))
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float DeltaTime)
+	{
+		bIsReleasePumpScheduled = false;
+		PumpQueue();
+		return false;
+	}));
+}
+
+void FHTTPRequestQueue::SetDefaultTimeouts(float InConnectTimeout, float InTimeout)
+{
+	DefaultConnectTimeout = FMath::Max(InConnectTimeout, 0.0f);
+	DefaultTimeout = FMath::Max(InTimeout, 0.0f);
+}
+
+bool FHTTPRequestQueue::IsQueued(int32 RequestId) const
+{
+	if (FindEntry(RequestId).IsValid())
+	{
+		return true;
+	}
+
+	// Followers don't have an entry of their own
+	auto HasFollower = [RequestId](const TSharedPtr<FHTTPQueuedRequest>& Entry)
+	{
+		return Entry->Followers.ContainsByPredicate([RequestId](const FHTTPQueuedFollower& Follower) { return Follower.RequestId == RequestId; });
+	};
+
+	for (const TPair<int32, TSharedPtr<FHTTPQueuedRequest>>& Pair : InFlight)
+	{
+		if (HasFollower(Pair.Value))
+		{
+			return true;
+		}
+	}
+
+	return Pending.ContainsByPredicate(HasFollower);
+}
+
+bool FHTTPRequestQueue::GetProgress(int32 RequestId, int64& OutBytesReceived, int64& OutTotalBytes) const
+{
+	OutBytesReceived = 0;
+	OutTotalBytes = -1;
+
+	TSharedPtr<FHTTPQueuedRequest> Entry = InFlight.FindRef(RequestId);
+	if (!Entry.IsValid())
+	{
+		for (const TPair<int32, TSharedPtr<FHTTPQueuedRequest>>& Pair : InFlight)
+		{
+			if (Pair.Value->Followers.ContainsByPredicate([RequestId](const FHTTPQueuedFollower& Follower) { return Follower.RequestId == RequestId; }))
+			{
+				Entry = Pair.Value;
+				break;
+			}
+		}
+	}
+
+	if (!Entry.IsValid() || !Entry->BytesReceived.IsValid())
+	{
+		return false;
+	}
+
+	OutBytesReceived = Entry->BytesReceived->load();
+	OutTotalBytes = Entry->ContentLength.IsValid() ? Entry->ContentLength->load() : -1;
+	return true;
+}
+
+double FHTTPRequestQueue::GetHostParkedFor(const FString& Host) const
+{
+	const double* ParkedUntil = ParkedHosts.Find(Host);
+	return ParkedUntil != nullptr ? FMath::Max(*ParkedUntil - FPlatformTime::Seconds(), 0.0) : 0.0;
+}
+
+// Sends pending requests in priority order, FIFO within a class, while slots are free - requests for a saturated host are skipped, not blocking the others;
+// --> Requests waiting for a retry or a parked host are skipped as well, a ticker pumps again once the earliest of them is ready;
+void FHTTPRequestQueue::PumpQueue()
+{
+	if (bIsPumping)
+	{
+		bPumpRequested = true;
+		return;
+	}
+
+	TGuardValue<bool> PumpGuard(bIsPumping, true);
+
+	do
+	{
+		bPumpRequested = false;
+
+		const double Now = FPlatformTime::Seconds();
+		double NextReadyTime = MAX_dbl;
+
+		for (int32 Index = 0; Index < Pending.Num() && InFlight.Num() < MaxInFlight; )
+		{
+			TSharedPtr<FHTTPQueuedRequest> Entry = Pending[Index];
+
+			if (Entry->IsCancelled() || Now >= Entry->GetDeadline())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FHTTPRequestQueue::Request %d %s before it was sent: %s"),
+					Entry->RequestId, Entry->IsCancelled() ? TEXT("was cancelled") : TEXT("expired"), *Entry->URL);
+				Pending.RemoveAt(Index);
+				CompleteEntryDeferred(Entry, nullptr, nullptr, false);
+				continue;
+			}
+
+			const double ReadyTime = GetReadyTime(*Entry);
+			if (ReadyTime > Now)
+			{
+				// Can't be sent before its deadline - fail it now instead of parking it for nothing
+				if (ReadyTime >= Entry->GetDeadline())
+				{
+					UE_LOG(LogTemp, Error, TEXT("FHTTPRequestQueue::Request %d would wait past its deadline: %s"), Entry->RequestId, *Entry->URL);
+					Pending.RemoveAt(Index);
+					CompleteEntryDeferred(Entry, nullptr, nullptr, false);
+					continue;
+				}
+
+				NextReadyTime = FMath::Min(NextReadyTime, ReadyTime);
+				++Index;
+				continue;
+			}
+
+			if (!CanDispatch(*Entry))
+			{
+				++Index;
+				continue;
+			}
+
+			// Backpressure - the request waits until buffered bodies are released, unless it can go to disk instead
+			if (!FitsMemoryBudget(*Entry))
+			{
+				if (!Entry->OnSpoolSetup)
+				{
+					++Index;
+					continue;
+				}
+
+				UE_LOG(LogTemp, Log, TEXT("FHTTPRequestQueue::Memory budget spent (%lld of %lld bytes) - spooling request %d to disk: %s"),
+					GetBufferedBytes(), MemoryBudget, Entry->RequestId, *Entry->URL);
+				Entry->bIsSpooled = true;
+			}
+
+			Pending.RemoveAt(Index);
+			Dispatch(Entry);
+		}
+
+		if (NextReadyTime < MAX_dbl)
+		{
+			ScheduleWakeUp(NextReadyTime);
+		}
+	}
+	while (bPumpRequested);
+}
+
+double FHTTPRequestQueue::GetReadyTime(const FHTTPQueuedRequest& Entry) const
+{
+	const double* ParkedUntil = ParkedHosts.Find(Entry.Host);
+	const double TokenWait = FHTTPRateLimiter::Get().GetWaitTime(Entry.Host, Entry.Priority == EHTTPRequestPriority::Interactive);
+	const double TokenReadyTime = TokenWait > 0.0 ? FPlatformTime::Seconds() + TokenWait : 0.0;
+
+	return FMath::Max3(Entry.NotBefore, ParkedUntil != nullptr ? *ParkedUntil : 0.0, TokenReadyTime);
+}
+
+void FHTTPRequestQueue::ScheduleWakeUp(double InWakeUpTime)
+{
+	if (WakeUpTickerHandle.IsValid())
+	{
+		if (WakeUpTime <= InWakeUpTime)
+		{
+			return;
+		}
+		FTSTicker::GetCoreTicker().RemoveTicker(WakeUpTickerHandle);
+	}
+
+	WakeUpTime = InWakeUpTime;
+	WakeUpTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float DeltaTime)
+	{
+		WakeUpTickerHandle.Reset();
+		PumpQueue();
+		return false;
+	}), static_cast<float>(FMath::Max(InWakeUpTime - FPlatformTime::Seconds(), 0.0)));
+}
+
+// Holds every request for the host until the rate limit window the server reported has passed
+void FHTTPRequestQueue::ParkHost(const FString& Host, const FHttpResponsePtr& Response)
+{
+	const double Wait = FHTTPRetryPolicy::GetRateLimitWait(Response);
+	if (Wait <= 0.0)
+	{
+		return;
+	}
+
+	double& ParkedUntil = ParkedHosts.FindOrAdd(Host);
+	ParkedUntil = FMath::Max(ParkedUntil, FPlatformTime::Seconds() + Wait);
+
+	UE_LOG(LogTemp, Warning, TEXT("FHTTPRequestQueue::%s is rate limited - holding its requests for %.0fs."), *Host, Wait);
+}
+
+int64 FHTTPRequestQueue::GetBufferCharge(const FHTTPQueuedRequest& Entry) const
+{
+	if (!Entry.bBuffersBody || Entry.bIsSpooled)
+	{
+		return 0;
+	}
+
+	const int64 ContentLength = Entry.ContentLength.IsValid() ? Entry.ContentLength->load() : -1;
+	if (ContentLength >= 0)
+	{
+		return ContentLength;
+	}
+
+	return Entry.ExpectedBodySize > 0 ? Entry.ExpectedBodySize : DefaultBodySize;
+}
+
+// Nothing buffered at all always fits - a body above the budget must not stall the queue forever
+bool FHTTPRequestQueue::FitsMemoryBudget(const FHTTPQueuedRequest& Entry) const
+{
+	const int64 Charge = GetBufferCharge(Entry);
+	if (MemoryBudget <= 0 || Charge <= 0)
+	{
+		return true;
+	}
+
+	const int64 BufferedBytes = GetBufferedBytes();
+	return BufferedBytes == 0 || BufferedBytes + Charge <= MemoryBudget;
+}
+
+bool FHTTPRequestQueue::CanDispatch(const FHTTPQueuedRequest& Entry) const
+{
+	// Everything but interactive requests leaves the reserved slots free
+	const bool bIsInteractive = Entry.Priority == EHTTPRequestPriority::Interactive;
+	const int32 Limit = bIsInteractive ? MaxInFlight : FMath::Max(MaxInFlight - ReservedSlots, 1);
+	const int32 HostLimit = bIsInteractive ? MaxInFlightPerHost : FMath::Max(MaxInFlightPerHost - ReservedSlotsPerHost, 1);
+
+	if (InFlight.Num() >= Limit)
+	{
+		return false;
+	}
+
+	const int32* HostInFlight = InFlightPerHost.Find(Entry.Host);
+	return HostInFlight == nullptr || *HostInFlight < HostLimit;
+}
+
+void FHTTPRequestQueue::Dispatch(const TSharedPtr<FHTTPQueuedRequest>& Entry)
+{
+	const int32 RequestId = Entry->RequestId;
+
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	Request->OnProcessRequestComplete().BindRaw(this, &FHTTPRequestQueue::OnRequestFinished, RequestId);
+	Request->SetURL(Entry->URL);
+	Request->SetVerb(Entry->Verb);
+	if (!Entry->Accept.IsEmpty())
+	{
+		Request->SetHeader(TEXT("Accept"), Entry->Accept);
+	}
+
+	Entry->HttpRequest = Request;
+	Entry->AttemptsMade++;
+	Entry->SendTime = FPlatformTime::Seconds();
+	Entry->bIsTimedOut = false;
+	if (Entry->FirstSendTime == 0.0)
+	{
+		Entry->FirstSendTime = Entry->SendTime;
+	}
+
+	// Only the first header of the attempt counts
+	TSharedRef<std::atomic<double>, ESPMode::ThreadSafe> FirstByteTime = MakeShared<std::atomic<double>, ESPMode::ThreadSafe>(0.0);
+	TSharedRef<std::atomic<int64>, ESPMode::ThreadSafe> ContentLength = MakeShared<std::atomic<int64>, ESPMode::ThreadSafe>(-1);
+	Entry->FirstByteTime = FirstByteTime;
+	Entry->ContentLength = ContentLength;
+
+	TSharedRef<std::atomic<int64>, ESPMode::ThreadSafe> BytesReceived = MakeShared<std::atomic<int64>, ESPMode::ThreadSafe>(0);
+	Request->OnRequestProgress64().BindLambda([BytesReceived](FHttpRequestPtr ProgressRequest, uint64 Sent, uint64 Received)
+	{
+		BytesReceived->store(static_cast<int64>(Received));
+	});
+	Entry->BytesReceived = BytesReceived;
+	InFlight.Add(RequestId, Entry);
+	InFlightPerHost.FindOrAdd(Entry->Host)++;
+
+	const FHTTPQueueSetupFunc& OnSetup = Entry->bIsSpooled ? Entry->OnSpoolSetup : Entry->OnSetup;
+	const bool bIsSetUp = !OnSetup || OnSetup(Request);
+
+	// Bound after OnSetup - a header handler it attached (e.g. a decoding response stream) is chained instead of replaced
+	const FHttpRequestHeaderReceivedDelegate SetupHeaderHandler = Request->OnHeaderReceived();
+	Request->OnHeaderReceived().BindLambda([FirstByteTime, ContentLength, SetupHeaderHandler](FHttpRequestPtr HeaderRequest, const FString& HeaderName, const FString& HeaderValue)
+	{
+		double Unset = 0.0;
+		FirstByteTime->compare_exchange_strong(Unset, FPlatformTime::Seconds());
+
+		// Replaces the estimate the request was admitted with
+		if (HeaderName == TEXT("Content-Length"))
+		{
+			ContentLength->store(FCString::Atoi64(*HeaderValue));
+		}
+
+		SetupHeaderHandler.ExecuteIfBound(HeaderRequest, HeaderName, HeaderValue);
+	});
+
+	if (bIsSetUp)
+	{
+		// Only requests that actually go out spend a token - a failed setup leaves the host's budget alone
+		FHTTPRateLimiter::Get().Acquire(Entry->Host);
+		if (Request->ProcessRequest())
+		{
+			return;
+		}
+	}
+
+	// The request may have completed from inside ProcessRequest already
+	if (!InFlight.Contains(RequestId))
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Error, TEXT("FHTTPRequestQueue::Failed to start request %d: %s"), RequestId, *Entry->URL);
+
+	InFlight.Remove(RequestId);
+	ReleaseHostSlot(Entry->Host);
+	Entry->HttpRequest.Reset();
+
+	CompleteEntryDeferred(Entry, Request, nullptr, false);
+}
+
+void FHTTPRequestQueue::ReleaseHostSlot(const FString& Host)
+{
+	if (int32* HostInFlight = InFlightPerHost.Find(Host))
+	{
+		if (--(*HostInFlight) <= 0)
+		{
+			InFlightPerHost.Remove(Host);
+		}
+	}
+}
+
+void FHTTPRequestQueue::OnRequestFinished(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId)
+{
+	TSharedPtr<FHTTPQueuedRequest> Entry;
+	if (!InFlight.RemoveAndCopyValue(RequestId, Entry))
+	{
+		return;
+	}
+
+	ReleaseHostSlot(Entry->Host);
+	Entry->HttpRequest.Reset();
+
+	// Nobody waits for the result anymore - never retried
+	if (Entry->IsCancelled())
+	{
+		CompleteEntry(Entry, Request, nullptr, false);
+		PumpQueue();
+		return;
+	}
+
+	// Whatever arrived before the timeout is incomplete
+	if (Entry->bIsTimedOut)
+	{
+		Response.Reset();
+		bWasSuccessful = false;
+	}
+
+	FHTTPRateLimiter::Get().UpdateFromResponse(Entry->Host, Response);
+	ParkHost(Entry->Host, Response);
+
+	const double Now = FPlatformTime::Seconds();
+	const double RetryDelay = Entry->RetryPolicy.GetRetryDelay(Entry->AttemptsMade, Response, bWasSuccessful);
+
+	// Waiting for the reset GitHub reported isn't part of the backoff schedule - only the hard cap applies to it
+	const double RetryDeadline = FHTTPRetryPolicy::GetRateLimitWait(Response) > 0.0 ? Entry->GetDeadline() : Entry->GetRetryDeadline();
+	if (RetryDelay >= 0.0 && Now + RetryDelay < RetryDeadline)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FHTTPRequestQueue::Request %d failed (%d) - retrying in %.1fs, attempt %d of %d: %s"),
+			RequestId, Response.IsValid() ? Response->GetResponseCode() : 0, RetryDelay, Entry->AttemptsMade + 1, Entry->RetryPolicy.MaxAttempts, *Entry->URL);
+
+		// Keeps its place ahead of newer requests of its class
+		Entry->NotBefore = Now + RetryDelay;
+		InsertPending(Entry, true);
+
+		PumpQueue();
+		return;
+	}
+
+	CompleteEntry(Entry, Request, Response, bWasSuccessful);
+
+	PumpQueue();
+}
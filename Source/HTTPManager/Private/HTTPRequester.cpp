@@ -2,45 +2,673 @@
 
 
 #include "HTTPRequester.h"
+#include "HTTPContentDecoder.h"
+#include "HTTPRequestQueue.h"
+#include "HTTPResponseCache.h"
+#include "HTTPResponseStream.h"
+#include "HTTPSegmentedDownload.h"
 
+#include "Async/Async.h"
 #include "HAL/PlatformFilemanager.h"
+#include "PlatformHttp.h"
+#include "Tasks/Task.h"
 
-void UHTTPRequester::DownloadFile(const FString& URL, bool bSaveToFile, FOnDownloadResponse Callback)
+int32 UHTTPRequester::DownloadFile(const FString& URL, bool bSaveToFile, FOnDownloadResponse Callback, bool bStreamToDisk, const FString& SavePath,
+	EHTTPHashAlgorithm HashAlgorithm, const FString& ExpectedHash, int64 ExpectedSize)
 {
-	// Store the Blueprint callback function
-	DownloadResponseDelegate = Callback;
+	// Store the Blueprint callback function along with the request
+	TSharedRef<FHTTPRequestContext> Context = CreateContext(URL, RequestPriority);
+	Context->Callback = Callback;
+	Context->bSaveToFile = bSaveToFile;
+	Context->bStreamToDisk = bStreamToDisk;
+	Context->SavePath = SavePath.IsEmpty() ? FPaths::ProjectSavedDir() / TEXT("HTTPDownloads") / FString::Printf(TEXT("DownloadedFile_%s.txt"), *FGuid::NewGuid().ToString()) : SavePath;
+	Context->HashAlgorithm = HashAlgorithm;
+	Context->ExpectedHash = ExpectedHash;
+	Context->ExpectedSize = ExpectedSize;
 
-	// Create an HTTP request
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, &UHTTPRequester::OnResponseReceived);
-	Request->SetURL(URL);
-	Request->SetVerb(TEXT("GET"));
-	Request->ProcessRequest();
+	// A known size below the threshold isn't worth the HEAD probe
+	const bool bIsBelowThreshold = ExpectedSize > 0 && ExpectedSize < SegmentedDownloadThreshold;
+	if (bStreamToDisk && bUseSegmentedDownloads && !bIsBelowThreshold && HashAlgorithm == EHTTPHashAlgorithm::None)
+	{
+		return StartSegmentedRequest(Context);
+	}
+
+	return StartRequest(Context);
+}
+
+int32 UHTTPRequester::DownloadBytes(const FString& URL, FOnDownloadBytesResponse Callback)
+{
+	TSharedRef<FHTTPRequestContext> Context = CreateContext(URL, RequestPriority);
+	Context->bReceiveBytes = true;
+	Context->BytesCallback = Callback;
+
+	return StartRequest(Context);
+}
+
+int32 UHTTPRequester::RequestBytes(const FString& URL, FHTTPBytesCompleteFunc OnComplete, const FHTTPRequestOptions& Options)
+{
+	TSharedRef<FHTTPResponseStream> Stream = FHTTPResponseStream::CreateMemoryStream(Options.ExpectedBodySize);
+
+	// Opened only if the queue spools the request - the body is read back once it's complete
+	const FString SpoolPath = FPaths::ProjectSavedDir() / TEXT("HTTPSpool") / FGuid::NewGuid().ToString() + TEXT(".bin");
+	TSharedRef<TSharedPtr<FHTTPResponseStream>> SpoolStream = MakeShared<TSharedPtr<FHTTPResponseStream>>();
+
+	auto AttachStream = [URL](const FHttpRequestRef& Request, const TSharedRef<FHTTPResponseStream>& BodyStream)
+	{
+		FHTTPResponseCache::Get().ApplyValidators(URL, Request);
+		if (FHTTPContentDecoder::ApplyAcceptEncoding(URL, Request))
+		{
+			BodyStream->EnableContentDecoding(Request);
+		}
+		return BodyStream->IsValid() && BodyStream->Restart() && Request->SetResponseBodyReceiveStream(BodyStream);
+	};
+
+	FHTTPRequestOptions BytesOptions = Options;
+	BytesOptions.bBuffersBody = true;
+	BytesOptions.OnSpoolSetup = [AttachStream, SpoolPath, SpoolStream](const FHttpRequestRef& Request)
+	{
+		if (!SpoolStream->IsValid())
+		{
+			*SpoolStream = FHTTPResponseStream::CreateFileStream(SpoolPath);
+		}
+		return AttachStream(Request, SpoolStream->ToSharedRef());
+	};
+
+	return FHTTPRequestQueue::Get().Enqueue(URL,
+		[AttachStream, Stream](const FHttpRequestRef& Request)
+		{
+			return AttachStream(Request, Stream);
+		},
+		[URL, Stream, SpoolPath, SpoolStream, OnComplete](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+		{
+			TArray<uint8> Content;
+			bool bIsOk = false;
+			const bool bIsFresh = bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+
+			if (bWasSuccessful && FHTTPResponseCache::IsNotModified(Response))
+			{
+				bIsOk = FHTTPResponseCache::Get().LoadBody(URL, Content);
+			}
+			else if (bIsFresh && SpoolStream->IsValid())
+			{
+				bIsOk = (*SpoolStream)->Commit() && FFileHelper::LoadFileToArray(Content, *SpoolPath);
+				if (bIsOk)
+				{
+					FHTTPResponseCache::Get().Store(URL, Response, Content);
+				}
+			}
+			else if (bIsFresh && Stream->Close())
+			{
+				Content = Stream->ReleaseBody();
+				FHTTPResponseCache::Get().Store(URL, Response, Content);
+				bIsOk = true;
+			}
+
+			if (SpoolStream->IsValid())
+			{
+				(*SpoolStream)->Discard();
+				IFileManager::Get().Delete(*SpoolPath, false, false, true);
+			}
+
+			if (OnComplete)
+			{
+				OnComplete(bIsOk, MoveTemp(Content));
+			}
+		},
+		BytesOptions);
+}
+
+int32 UHTTPRequester::DownloadFiles(const TArray<FString>& URLs, const FString& SaveDirectory, FOnDownloadBatchComplete BatchCallback)
+{
+	const int32 BatchId = NextBatchId++;
+
+	if (URLs.IsEmpty())
+	{
+		BatchCallback.ExecuteIfBound(BatchId, 0, TArray<FString>());
+		return BatchId;
+	}
+
+	FHTTPBatchContext& Batch = ActiveBatches.Add(BatchId);
+	Batch.Remaining = URLs.Num();
+	Batch.Callback = BatchCallback;
+
+	// Two URLs of a batch never stream into the same file
+	TSet<FString> SavePaths;
+
+	for (const FString& URL : URLs)
+	{
+		TSharedRef<FHTTPRequestContext> Context = CreateContext(URL, BatchPriority);
+		Context->BatchId = BatchId;
+
+		if (!SaveDirectory.IsEmpty())
+		{
+			// Drop the scheme, the host and the query string - the URL path is kept below SaveDirectory,
+			// so same-named files of different folders don't overwrite each other
+			FString RelativePath = URL;
+			RelativePath.Split(TEXT("?"), &RelativePath, nullptr);
+			RelativePath.Split(TEXT("#"), &RelativePath, nullptr);
+
+			int32 SchemeEnd = RelativePath.Find(TEXT("://"));
+			if (SchemeEnd != INDEX_NONE)
+			{
+				RelativePath.RightChopInline(SchemeEnd + 3);
+				int32 PathStart = INDEX_NONE;
+				RelativePath = RelativePath.FindChar(TEXT('/'), PathStart) ? RelativePath.RightChop(PathStart) : FString();
+			}
+
+			RelativePath = FPlatformHttp::UrlDecode(RelativePath);
+			int32 NumSlashes = 0;
+			while (NumSlashes < RelativePath.Len() && RelativePath[NumSlashes] == TEXT('/'))
+			{
+				NumSlashes++;
+			}
+			RelativePath.RightChopInline(NumSlashes);
+
+			// ".." segments must not climb out of SaveDirectory
+			FString SavePath = SaveDirectory / RelativePath;
+			const bool bIsInside = !RelativePath.IsEmpty() && FPaths::CollapseRelativeDirectories(SavePath) && FPaths::IsUnderDirectory(SavePath, SaveDirectory);
+
+			bool bIsDuplicate = false;
+			SavePaths.Add(FPaths::ConvertRelativePathToFull(SavePath), &bIsDuplicate);
+
+			if (!bIsInside || bIsDuplicate)
+			{
+				UE_LOG(LogTemp, Error, TEXT("DownloadFiles::Rejected %s - %s."), *URL, bIsInside ? TEXT("another URL of the batch saves to the same file") : TEXT("no file path below SaveDirectory"));
+				Batch.FailedURLs.Add(URL);
+				Batch.Remaining--;
+				continue;
+			}
+
+			Context->bStreamToDisk = true;
+			Context->SavePath = SavePath;
+		}
+
+		StartRequest(Context);
+	}
+
+	// Every URL was rejected - nothing will complete the batch
+	if (Batch.Remaining <= 0)
+	{
+		FHTTPBatchContext FinishedBatch = MoveTemp(Batch);
+		ActiveBatches.Remove(BatchId);
+		FinishedBatch.Callback.ExecuteIfBound(BatchId, 0, FinishedBatch.FailedURLs);
+	}
+
+	return BatchId;
+}
+
+void UHTTPRequester::SetDownloadConcurrency(int32 MaxInFlight, int32 MaxInFlightPerHost)
+{
+	FHTTPRequestQueue::Get().SetMaxInFlight(MaxInFlight, MaxInFlightPerHost);
+}
+
+void UHTTPRequester::SetReservedSlots(int32 ReservedSlots, int32 ReservedSlotsPerHost)
+{
+	FHTTPRequestQueue::Get().SetReservedSlots(ReservedSlots, ReservedSlotsPerHost);
+}
+
+void UHTTPRequester::SetMemoryBudget(int32 MaxBufferedMB)
+{
+	FHTTPRequestQueue::Get().SetMemoryBudget(static_cast<int64>(FMath::Max(MaxBufferedMB, 0)) * 1024 * 1024);
+}
+
+int32 UHTTPRequester::GetBufferedMemoryMB() const
+{
+	return static_cast<int32>(FHTTPRequestQueue::Get().GetBufferedBytes() / (1024 * 1024));
 }
 
-void UHTTPRequester::OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+void UHTTPRequester::SetRequestTimeouts(float ConnectTimeout, float Timeout)
 {
-	if (bWasSuccessful && Response.IsValid())
+	FHTTPRequestQueue::Get().SetDefaultTimeouts(ConnectTimeout, Timeout);
+}
+
+bool UHTTPRequester::CancelRequest(int32 RequestId)
+{
+	const TSharedPtr<FHTTPRequestContext> Context = ActiveRequests.FindRef(RequestId);
+	if (!Context.IsValid() || !Context->CancellationToken.IsValid())
+	{
+		return false;
+	}
+
+	Context->CancellationToken->Cancel();
+	return true;
+}
+
+void UHTTPRequester::CancelAllRequests()
+{
+	if (RequestsToken.IsValid())
+	{
+		// Requests started afterwards get a fresh parent
+		TSharedPtr<FHTTPCancellationToken> Token = MoveTemp(RequestsToken);
+		Token->Cancel();
+	}
+}
+
+void UHTTPRequester::NativeDestruct()
+{
+	CancelAllRequests();
+
+	if (ProgressTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(ProgressTickerHandle);
+		ProgressTickerHandle.Reset();
+	}
+
+	Super::NativeDestruct();
+}
+
+void UHTTPRequester::EnsureProgressTicker()
+{
+	if (ProgressTickerHandle.IsValid())
+	{
+		return;
+	}
+
+	TWeakObjectPtr<UHTTPRequester> WeakThis(this);
+	ProgressTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis](float DeltaTime)
+	{
+		UHTTPRequester* Requester = WeakThis.Get();
+		return Requester != nullptr && Requester->TickProgress();
+	}), FMath::Max(ProgressIntervalMs, 16) / 1000.0f);
+}
+
+// Returns false once nothing is active anymore - the next request starts the ticker again
+bool UHTTPRequester::TickProgress()
+{
+	if (ActiveRequests.IsEmpty())
+	{
+		ProgressTickerHandle.Reset();
+		return false;
+	}
+
+	if (!OnDownloadProgress.IsBound())
 	{
-		FString FileContent = Response->GetContentAsString();
-		UE_LOG(LogTemp, Log, TEXT("Downloaded content: %s"), *FileContent);
+		return true;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	// Collected first - a handler may start or cancel requests
+	TArray<TSharedPtr<FHTTPRequestContext>> Updated;
+	TArray<int64> TotalBytes;
+	for (const TPair<int32, TSharedPtr<FHTTPRequestContext>>& Pair : ActiveRequests)
+	{
+		FHTTPRequestContext& Context = *Pair.Value;
 
-		// Call the Blueprint event if it's valid
-		if (DownloadResponseDelegate.IsBound())
+		int64 Received = 0;
+		int64 Total = -1;
+		if (Context.SegmentedDownload.IsValid())
 		{
-			DownloadResponseDelegate.Execute(FileContent);
+			Received = Context.SegmentedDownload->GetBytesReceived();
+			Total = Context.SegmentedDownload->GetTotalSize() > 0 ? Context.SegmentedDownload->GetTotalSize() : -1;
+		}
+		else if (!FHTTPRequestQueue::Get().GetProgress(Context.QueueRequestId, Received, Total))
+		{
+			continue;
+		}
 
-            // Save the file locally (optional)
-            FString SavePath = FPaths::ProjectDir() + TEXT("DownloadedFile.txt");
-            FFileHelper::SaveStringToFile(FileContent, *SavePath);
+		if (Context.Progress.Update(Received, Now))
+		{
+			Updated.Add(Pair.Value);
+			TotalBytes.Add(Total);
 		}
 	}
+
+	for (int32 Index = 0; Index < Updated.Num(); ++Index)
+	{
+		const FHTTPRequestContext& Context = *Updated[Index];
+		OnDownloadProgress.Broadcast(Context.RequestId, Context.Progress.BytesReceived, TotalBytes[Index], Context.Progress.BytesPerSec);
+	}
+
+	return true;
+}
+
+TSharedRef<FHTTPRequestContext> UHTTPRequester::CreateContext(const FString& URL, EHTTPRequestPriority Priority)
+{
+	if (!RequestsToken.IsValid())
+	{
+		RequestsToken = FHTTPCancellationToken::Create();
+	}
+
+	TSharedRef<FHTTPRequestContext> Context = MakeShared<FHTTPRequestContext>();
+	Context->URL = URL;
+	Context->Priority = Priority;
+	Context->CancellationToken = RequestsToken->CreateChild();
+	return Context;
+}
+
+FHTTPRequestOptions UHTTPRequester::MakeRequestOptions(const FHTTPRequestContext& Context) const
+{
+	FHTTPRequestOptions Options;
+	Options.Priority = Context.Priority;
+	Options.CancellationToken = Context.CancellationToken;
+	// Streamed bodies go straight to disk
+	Options.bBuffersBody = !Context.bStreamToDisk;
+	return Options;
+}
+
+void UHTTPRequester::SetRetryPolicy(int32 MaxAttempts, float BaseDelay, float MaxDelay, float Deadline)
+{
+	FHTTPRetryPolicy Policy;
+	Policy.MaxAttempts = FMath::Max(MaxAttempts, 1);
+	Policy.BaseDelay = FMath::Max(BaseDelay, 0.0f);
+	Policy.MaxDelay = FMath::Max(MaxDelay, Policy.BaseDelay);
+	Policy.Deadline = FMath::Max(Deadline, 0.0f);
+
+	FHTTPRequestQueue::Get().SetRetryPolicy(Policy);
+}
+
+void UHTTPRequester::SetResponseCacheSize(int32 MaxSizeMB)
+{
+	FHTTPResponseCache::Get().SetMaxSize(static_cast<int64>(FMath::Max(MaxSizeMB, 0)) * 1024 * 1024);
+}
+
+void UHTTPRequester::ClearResponseCache()
+{
+	FHTTPResponseCache::Get().Clear();
+}
+
+bool UHTTPRequester::GetRequestTimingStats(const FString& Key, EHTTPTimingPhase Phase, FHTTPTimingStats& OutStats) const
+{
+	return FHTTPMetrics::Get().GetStats(Key, Phase, OutStats);
+}
+
+TArray<FString> UHTTPRequester::GetRequestTimingKeys() const
+{
+	return FHTTPMetrics::Get().GetKeys();
+}
+
+bool UHTTPRequester::ExportRequestTimingsCSV(const FString& FilePath)
+{
+	return FHTTPMetrics::Get().ExportCSV(FilePath.IsEmpty() ? FPaths::ProjectSavedDir() / TEXT("HTTPMetrics") / TEXT("RequestTimings.csv") : FilePath);
+}
+
+void UHTTPRequester::ResetRequestTimings()
+{
+	FHTTPMetrics::Get().Reset();
+}
+
+bool UHTTPRequester::IsRequestActive(int32 RequestId) const
+{
+	return ActiveRequests.Contains(RequestId);
+}
+
+TArray<int32> UHTTPRequester::GetActiveRequestIds() const
+{
+	TArray<int32> RequestIds;
+	ActiveRequests.GetKeys(RequestIds);
+	return RequestIds;
+}
+
+// Hands the request over to the shared queue - the stream is opened only once the request actually leaves the queue
+// In-memory requests are coalesced - several widgets asking for the same URL at once share a single network request
+int32 UHTTPRequester::StartRequest(const TSharedRef<FHTTPRequestContext>& Context)
+{
+	TWeakObjectPtr<UHTTPRequester> WeakThis(this);
+
+	FHTTPQueueCompleteFunc OnComplete = [WeakThis, Context](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+	{
+		if (UHTTPRequester* Requester = WeakThis.Get())
+		{
+			Requester->OnResponseReceived(Request, Response, bWasSuccessful, Context);
+		}
+		else if (Context->ResponseStream.IsValid())
+		{
+			Context->ResponseStream->Discard();
+		}
+	};
+
+	int32 RequestId = INDEX_NONE;
+	if (Context->bStreamToDisk)
+	{
+		RequestId = FHTTPRequestQueue::Get().Enqueue(Context->URL,
+			[Context](const FHttpRequestRef& Request)
+			{
+				// Streaming mode - the body never lands in memory as a whole, a retry truncates the ".part" file of the previous attempt
+				TSharedRef<FHTTPResponseStream> Stream = Context->ResponseStream.IsValid() ? Context->ResponseStream.ToSharedRef() : FHTTPResponseStream::CreateFileStream(Context->SavePath);
+				if (!Context->ResponseStream.IsValid() && Context->HashAlgorithm != EHTTPHashAlgorithm::None)
+				{
+					Stream->SetExpectedHash(Context->HashAlgorithm, Context->ExpectedHash, Context->ExpectedSize);
+				}
+				if (FHTTPContentDecoder::ApplyAcceptEncoding(Context->URL, Request))
+				{
+					Stream->EnableContentDecoding(Request);
+				}
+				if (!Stream->Restart() || !Request->SetResponseBodyReceiveStream(Stream))
+				{
+					UE_LOG(LogTemp, Error, TEXT("DownloadFile::Failed to set up streaming to %s."), *Context->SavePath);
+					Stream->Discard();
+					return false;
+				}
+				Context->ResponseStream = Stream;
+				return true;
+			},
+			MoveTemp(OnComplete), MakeRequestOptions(*Context));
+	}
 	else
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to download file!"));
-		if (DownloadResponseDelegate.IsBound())
+		const FString URL = Context->URL;
+		RequestId = FHTTPRequestQueue::Get().EnqueueCoalesced(URL,
+			[URL](const FHttpRequestRef& Request)
+			{
+				// In-memory bodies can be revalidated - a 304 is answered from the cache, a compressed body is decoded by it
+				FHTTPResponseCache::Get().ApplyValidators(URL, Request);
+				FHTTPContentDecoder::ApplyAcceptEncoding(URL, Request);
+				return true;
+			},
+			MoveTemp(OnComplete), MakeRequestOptions(*Context));
+	}
+
+	// A segmented download falling back keeps the ID Blueprints already got
+	Context->QueueRequestId = RequestId;
+	if (Context->RequestId == INDEX_NONE)
+	{
+		Context->RequestId = RequestId;
+		ActiveRequests.Add(RequestId, Context);
+	}
+
+	EnsureProgressTicker();
+
+	return Context->RequestId;
+}
+
+// Probes the server first - files that can't or shouldn't be split continue as a regular streamed request
+int32 UHTTPRequester::StartSegmentedRequest(const TSharedRef<FHTTPRequestContext>& Context)
+{
+	FHTTPSegmentedSettings Settings;
+	Settings.SegmentCount = DownloadSegmentCount;
+	Settings.MinSegmentedSize = SegmentedDownloadThreshold;
+	Settings.Priority = Context->Priority;
+	Settings.CancellationToken = Context->CancellationToken;
+
+	Context->SegmentedDownload = FHTTPSegmentedDownload::Create(Context->URL, Context->SavePath, Settings);
+
+	TWeakObjectPtr<UHTTPRequester> WeakThis(this);
+	Context->RequestId = Context->SegmentedDownload->Start([WeakThis, Context](EHTTPSegmentedResult Result, int64 BytesWritten)
+	{
+		Context->SegmentedDownload.Reset();
+
+		UHTTPRequester* Requester = WeakThis.Get();
+		if (Requester == nullptr)
+		{
+			return;
+		}
+
+		if (Result == EHTTPSegmentedResult::Unsupported)
 		{
-			DownloadResponseDelegate.Execute(TEXT("ERROR"));
+			Requester->StartRequest(Context);
+			return;
 		}
+
+		Requester->ActiveRequests.Remove(Context->RequestId);
+
+		if (Result == EHTTPSegmentedResult::Succeeded)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Downloaded %lld bytes to: %s"), BytesWritten, *Context->SavePath);
+			Requester->CompleteRequest(*Context, true, Context->SavePath);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Failed to download file!"));
+			Requester->CompleteRequest(*Context, false, TEXT("ERROR"));
+		}
+	});
+
+	ActiveRequests.Add(Context->RequestId, Context);
+	EnsureProgressTicker();
+	return Context->RequestId;
+}
+
+// The body is resolved, decoded, converted and written on a worker task - only the callbacks run on the game thread
+void UHTTPRequester::OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TSharedRef<FHTTPRequestContext> Context)
+{
+	ActiveRequests.Remove(Context->RequestId);
+
+	// An in-memory body stays charged against the memory budget until the worker is done with it - coalesced callers share one charge
+	TSharedPtr<FHTTPBufferHold, ESPMode::ThreadSafe> BufferHold;
+	if (!Context->ResponseStream.IsValid())
+	{
+		BufferHold = FHTTPRequestQueue::Get().GetCompletingBufferHold();
 	}
-}
\ No newline at end of file
+
+	TWeakObjectPtr<UHTTPRequester> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Response, bWasSuccessful, Context, BufferHold]()
+	{
+		const double WorkerStartTime = FPlatformTime::Seconds();
+		TSharedRef<FHTTPProcessedResponse> Result = MakeShared<FHTTPProcessedResponse>();
+		ProcessResponse(*Context, Response, bWasSuccessful, *Result);
+		FHTTPMetrics::Get().RecordWorker(Context->URL, FPlatformTime::Seconds() - WorkerStartTime);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Context, Result]()
+		{
+			if (UHTTPRequester* Requester = WeakThis.Get())
+			{
+				Requester->FinishResponse(*Context, *Result);
+			}
+		});
+	});
+}
+
+// Worker task - touches nothing but the context, the response and thread-safe caches
+void UHTTPRequester::ProcessResponse(const FHTTPRequestContext& Context, const FHttpResponsePtr& Response, bool bWasSuccessful, FHTTPProcessedResponse& OutResult)
+{
+	const bool bIsOk = bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+
+	// Binary body - passed on as received, the response may be shared with coalesced requests so it's only read
+	if (Context.bReceiveBytes)
+	{
+		// 304 from the cache, 2xx decoded and stored
+		OutResult.bIsOk = bWasSuccessful && FHTTPResponseCache::Get().ResolveBody(Context.URL, Response, OutResult.Content);
+		return;
+	}
+
+	// Streamed body - it's already on disk, only commit or drop the ".part" file
+	if (Context.ResponseStream.IsValid())
+	{
+		TSharedPtr<FHTTPResponseStream> Stream = Context.ResponseStream;
+
+		OutResult.bIsOk = bIsOk && Stream->Commit();
+		if (OutResult.bIsOk)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Downloaded %lld bytes to: %s"), Stream->GetBytesReceived(), *Stream->GetTargetPath());
+			OutResult.FileContent = Stream->GetTargetPath();
+		}
+		else
+		{
+			Stream->Discard();
+		}
+		return;
+	}
+
+	if (bWasSuccessful && Response.IsValid() && !Context.bStreamToDisk)
+	{
+		// Fresh or revalidated body only - error bodies and a 304 without a cached body are failures, never content
+		TArray<uint8> Body;
+		if (!FHTTPResponseCache::Get().ResolveBody(Context.URL, Response, Body))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Unexpected response %d for %s."), Response->GetResponseCode(), *Context.URL);
+			return;
+		}
+
+		// Verified before anything is saved - the body is already in memory, hashing it costs no extra read
+		if (Context.HashAlgorithm != EHTTPHashAlgorithm::None)
+		{
+			FHTTPStreamHasher Hasher(Context.HashAlgorithm, Body.Num());
+			Hasher.Update(Body.GetData(), Body.Num());
+
+			const FString ComputedHash = Hasher.Finalize();
+			if (!FHTTPStreamHasher::Matches(ComputedHash, Context.ExpectedHash))
+			{
+				UE_LOG(LogTemp, Error, TEXT("Hash mismatch for %s - expected %s, received %s."), *Context.URL, *Context.ExpectedHash, *ComputedHash);
+				return;
+			}
+		}
+
+		OutResult.FileContent = FHTTPResponseCache::BytesToString(Body);
+		UE_LOG(LogTemp, Verbose, TEXT("Downloaded %d bytes: %s"), Body.Num(), *Context.URL);
+
+		// Save the file locally (optional) - raw bytes, so binary payloads survive
+		if (Context.bSaveToFile && !FFileHelper::SaveArrayToFile(Body, *Context.SavePath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Failed to save %s to %s."), *Context.URL, *Context.SavePath);
+		}
+
+		OutResult.bIsOk = true;
+	}
+}
+
+void UHTTPRequester::FinishResponse(FHTTPRequestContext& Context, FHTTPProcessedResponse& Result)
+{
+	if (!Result.bIsOk)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to download file!"));
+	}
+
+	if (Context.bReceiveBytes)
+	{
+		Context.BytesCallback.ExecuteIfBound(Result.bIsOk, Result.Content);
+		CompleteRequest(Context, Result.bIsOk, Result.bIsOk ? FString() : TEXT("ERROR"));
+		return;
+	}
+
+	CompleteRequest(Context, Result.bIsOk, Result.bIsOk ? Result.FileContent : TEXT("ERROR"));
+}
+
+void UHTTPRequester::CompleteRequest(FHTTPRequestContext& Context, bool bWasSuccessful, const FString& FileContent)
+{
+	// Call the Blueprint event if it's valid
+	if (Context.Callback.IsBound())
+	{
+		Context.Callback.Execute(FileContent);
+	}
+
+	OnRequestCompleted.Broadcast(Context.RequestId, bWasSuccessful, FileContent);
+
+	// Close the batch once its last request is in
+	if (Context.BatchId == INDEX_NONE)
+	{
+		return;
+	}
+
+	FHTTPBatchContext* Batch = ActiveBatches.Find(Context.BatchId);
+	if (Batch == nullptr)
+	{
+		return;
+	}
+
+	if (bWasSuccessful)
+	{
+		Batch->SucceededCount++;
+	}
+	else
+	{
+		Batch->FailedURLs.Add(Context.URL);
+	}
+
+	if (--Batch->Remaining <= 0)
+	{
+		FHTTPBatchContext FinishedBatch = MoveTemp(*Batch);
+		ActiveBatches.Remove(Context.BatchId);
+		FinishedBatch.Callback.ExecuteIfBound(Context.BatchId, FinishedBatch.SucceededCount, FinishedBatch.FailedURLs);
+	}
+}
@@ -0,0 +1,399 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPResponseCache.h"
+#include "HTTPContentDecoder.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace HTTPResponseCache
+{
+	// Bump when FHTTPCacheEntry changes - an index of another version is dropped
+	static const uint32 IndexMagic = 0x48434958; // "HCIX"
+	// 2 - entries keyed on URL and Accept, a URL-only entry of version 1 may hold any representation
+	static const int32 IndexVersion = 2;
+
+	// Index writes are batched - hits only bump LastAccess
+	static const float SaveDelay = 2.0f;
+}
+
+FHTTPResponseCache& FHTTPResponseCache::Get()
+{
+	static FHTTPResponseCache Instance;
+	return Instance;
+}
+
+FHTTPResponseCache::~FHTTPResponseCache()
+{
+	if (SaveTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(SaveTickerHandle);
+	}
+}
+
+FString FHTTPResponseCache::GetEntryKey(const FString& URL, const FString& Accept)
+{
+	return Accept.IsEmpty() ? URL : FString::Printf(TEXT("%s Accept: %s"), *URL, *Accept);
+}
+
+FString FHTTPResponseCache::GetCacheDir() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("HTTPCache");
+}
+
+FString FHTTPResponseCache::GetBlobPath(const FString& ContentHash) const
+{
+	// Two-character fan-out keeps directories small
+	return GetCacheDir() / TEXT("Blobs") / ContentHash.Left(2) / ContentHash;
+}
+
+bool FHTTPResponseCache::IsNotModified(const FHttpResponsePtr& Response)
+{
+	return Response.IsValid() && Response->GetResponseCode() == EHttpResponseCodes::NotModified;
+}
+
+void FHTTPResponseCache::ApplyValidators(const FString& URL, const FHttpRequestRef& Request, const FString& Accept)
+{
+	FScopeLock Lock(&CacheLock);
+	LoadIndex();
+
+	const FHTTPCacheEntry* Entry = Entries.Find(GetEntryKey(URL, Accept));
+	if (Entry == nullptr)
+	{
+		return;
+	}
+
+	if (!Entry->ETag.IsEmpty())
+	{
+		Request->SetHeader(TEXT("If-None-Match"), Entry->ETag);
+	}
+	if (!Entry->LastModified.IsEmpty())
+	{
+		Request->SetHeader(TEXT("If-Modified-Since"), Entry->LastModified);
+	}
+}
+
+void FHTTPResponseCache::Store(const FString& URL, const FHttpResponsePtr& Response, const TArray<uint8>& Body, const FString& Accept)
+{
+	if (!Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		return;
+	}
+
+	FHTTPCacheEntry NewEntry;
+	NewEntry.ETag = Response->GetHeader(TEXT("ETag"));
+	NewEntry.LastModified = Response->GetHeader(TEXT("Last-Modified"));
+	if (NewEntry.ETag.IsEmpty() && NewEntry.LastModified.IsEmpty())
+	{
+		return;
+	}
+
+	// Hashed before taking the lock - other tasks keep resolving meanwhile
+	FSHAHash Hash;
+	FSHA1::HashBuffer(Body.GetData(), Body.Num(), Hash.Hash);
+
+	FScopeLock Lock(&CacheLock);
+	LoadIndex();
+
+	// Bigger than the whole cache - never worth keeping
+	if (Body.Num() > MaxSizeBytes)
+	{
+		return;
+	}
+
+	NewEntry.ContentHash = Hash.ToString();
+	NewEntry.Size = Body.Num();
+	NewEntry.LastAccess = FDateTime::UtcNow().ToUnixTimestamp();
+
+	// Identical body already on disk - only the index changes
+	const bool bIsBlobStored = BlobReferences.Contains(NewEntry.ContentHash);
+	if (!bIsBlobStored && !FFileHelper::SaveArrayToFile(Body, *GetBlobPath(NewEntry.ContentHash)))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FHTTPResponseCache::Failed to store the body of %s."), *URL);
+		return;
+	}
+
+	const FString Key = GetEntryKey(URL, Accept);
+	RemoveEntry(Key);
+	AddBlobReference(NewEntry);
+	Entries.Add(Key, NewEntry);
+
+	EvictToFit();
+	MarkDirty();
+}
+
+bool FHTTPResponseCache::LoadBody(const FString& URL, TArray<uint8>& OutBody, const FString& Accept)
+{
+	FScopeLock Lock(&CacheLock);
+	LoadIndex();
+
+	const FString Key = GetEntryKey(URL, Accept);
+	FHTTPCacheEntry* Entry = Entries.Find(Key);
+	if (Entry == nullptr)
+	{
+		return false;
+	}
+
+	// The blob was removed behind our back - forget the URL so the next request is unconditional
+	if (!FFileHelper::LoadFileToArray(OutBody, *GetBlobPath(Entry->ContentHash)) || OutBody.Num() != Entry->Size)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FHTTPResponseCache::Blob for %s is missing - dropping the entry."), *URL);
+		RemoveEntry(Key);
+		MarkDirty();
+		OutBody.Reset();
+		return false;
+	}
+
+	Entry->LastAccess = FDateTime::UtcNow().ToUnixTimestamp();
+	MarkDirty();
+	return true;
+}
+
+bool FHTTPResponseCache::ResolveBody(const FString& URL, const FHttpResponsePtr& Response, TArray<uint8>& OutBody, const FString& Accept)
+{
+	if (IsNotModified(Response))
+	{
+		if (LoadBody(URL, OutBody, Accept))
+		{
+			UE_LOG(LogTemp, Log, TEXT("FHTTPResponseCache::%s not modified - using the cached body."), *URL);
+			return true;
+		}
+
+		UE_LOG(LogTemp, Error, TEXT("FHTTPResponseCache::304 for %s but no cached body."), *URL);
+		return false;
+	}
+
+	if (!Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		return false;
+	}
+
+	// Backends that don't decode Content-Encoding themselves hand over the compressed body - anything else stays as it was sent
+	const bool bIsEncoded = FHTTPContentDecoder::ShouldDecode(URL) && FHTTPContentDecoder::IsContentEncoded(Response);
+	if (!FHTTPContentDecoder::DecodeBody(Response->GetContent(), bIsEncoded, OutBody))
+	{
+		return false;
+	}
+
+	Store(URL, Response, OutBody, Accept);
+	return true;
+}
+
+bool FHTTPResponseCache::ResolveBodyAsString(const FString& URL, const FHttpResponsePtr& Response, FString& OutBody, const FString& Accept)
+{
+	TArray<uint8> Body;
+	if (!ResolveBody(URL, Response, Body, Accept))
+	{
+		return false;
+	}
+
+	OutBody = BytesToString(Body);
+	return true;
+}
+
+FString FHTTPResponseCache::BytesToString(const TArray<uint8>& Body)
+{
+	FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Body.GetData()), Body.Num());
+	return FString(Converter.Length(), Converter.Get());
+}
+
+void FHTTPResponseCache::SetMaxSize(int64 InMaxSizeBytes)
+{
+	FScopeLock Lock(&CacheLock);
+	LoadIndex();
+
+	MaxSizeBytes = FMath::Max<int64>(InMaxSizeBytes, 0);
+	EvictToFit();
+	MarkDirty();
+}
+
+int64 FHTTPResponseCache::GetMaxSize() const
+{
+	FScopeLock Lock(&CacheLock);
+	return MaxSizeBytes;
+}
+
+int64 FHTTPResponseCache::GetTotalSize() const
+{
+	FScopeLock Lock(&CacheLock);
+	return TotalBlobSize;
+}
+
+int32 FHTTPResponseCache::GetNumEntries() const
+{
+	FScopeLock Lock(&CacheLock);
+	return Entries.Num();
+}
+
+void FHTTPResponseCache::Clear()
+{
+	FScopeLock Lock(&CacheLock);
+
+	Entries.Empty();
+	BlobReferences.Empty();
+	TotalBlobSize = 0;
+	bIsIndexLoaded = true;
+
+	IFileManager::Get().DeleteDirectory(*(GetCacheDir() / TEXT("Blobs")), false, true);
+	SaveIndex();
+}
+
+void FHTTPResponseCache::AddBlobReference(const FHTTPCacheEntry& Entry)
+{
+	int32& References = BlobReferences.FindOrAdd(Entry.ContentHash);
+	if (References++ == 0)
+	{
+		TotalBlobSize += Entry.Size;
+	}
+}
+
+void FHTTPResponseCache::ReleaseBlobReference(const FHTTPCacheEntry& Entry)
+{
+	int32* References = BlobReferences.Find(Entry.ContentHash);
+	if (References == nullptr || --(*References) > 0)
+	{
+		return;
+	}
+
+	// Last URL pointing at the blob is gone
+	BlobReferences.Remove(Entry.ContentHash);
+	TotalBlobSize -= Entry.Size;
+	IFileManager::Get().Delete(*GetBlobPath(Entry.ContentHash), false, true, true);
+}
+
+void FHTTPResponseCache::RemoveEntry(const FString& URL)
+{
+	FHTTPCacheEntry OldEntry;
+	if (Entries.RemoveAndCopyValue(URL, OldEntry))
+	{
+		ReleaseBlobReference(OldEntry);
+	}
+}
+
+// Drops least recently used URLs until the unique blobs fit the cap
+void FHTTPResponseCache::EvictToFit()
+{
+	if (TotalBlobSize <= MaxSizeBytes)
+	{
+		return;
+	}
+
+	TArray<TPair<int64, FString>> ByLastAccess;
+	ByLastAccess.Reserve(Entries.Num());
+	for (const TPair<FString, FHTTPCacheEntry>& Pair : Entries)
+	{
+		ByLastAccess.Emplace(Pair.Value.LastAccess, Pair.Key);
+	}
+	ByLastAccess.Sort([](const TPair<int64, FString>& A, const TPair<int64, FString>& B) { return A.Key < B.Key; });
+
+	for (const TPair<int64, FString>& Candidate : ByLastAccess)
+	{
+		if (TotalBlobSize <= MaxSizeBytes)
+		{
+			break;
+		}
+		RemoveEntry(Candidate.Value);
+	}
+}
+
+void FHTTPResponseCache::LoadIndex()
+{
+	if (bIsIndexLoaded)
+	{
+		return;
+	}
+	bIsIndexLoaded = true;
+
+	// Per-URL bodies and JSON index of the first cache version - nothing worth migrating
+	const FString LegacyIndexPath = GetCacheDir() / TEXT("CacheIndex.json");
+	if (IFileManager::Get().FileExists(*LegacyIndexPath))
+	{
+		TArray<FString> LegacyBodies;
+		IFileManager::Get().FindFiles(LegacyBodies, *(GetCacheDir() / TEXT("*.body")), true, false);
+		for (const FString& LegacyBody : LegacyBodies)
+		{
+			IFileManager::Get().Delete(*(GetCacheDir() / LegacyBody), false, true, true);
+		}
+		IFileManager::Get().Delete(*LegacyIndexPath, false, true, true);
+	}
+
+	TArray<uint8> IndexData;
+	if (!FFileHelper::LoadFileToArray(IndexData, *(GetCacheDir() / TEXT("CacheIndex.bin")), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(IndexData);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Reader << Magic << Version;
+	if (Magic != HTTPResponseCache::IndexMagic || Version != HTTPResponseCache::IndexVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FHTTPResponseCache::CacheIndex.bin has an unknown format - starting empty."));
+
+		// Nothing references the blobs of another index any more
+		IFileManager::Get().DeleteDirectory(*(GetCacheDir() / TEXT("Blobs")), false, true);
+		return;
+	}
+
+	Reader << MaxSizeBytes;
+	Reader << Entries;
+	if (Reader.IsError())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FHTTPResponseCache::CacheIndex.bin is corrupted - starting empty."));
+		Entries.Empty();
+		return;
+	}
+
+	for (const TPair<FString, FHTTPCacheEntry>& Pair : Entries)
+	{
+		AddBlobReference(Pair.Value);
+	}
+}
+
+void FHTTPResponseCache::SaveIndex()
+{
+	if (SaveTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(SaveTickerHandle);
+		SaveTickerHandle.Reset();
+	}
+
+	TArray<uint8> IndexData;
+	FMemoryWriter Writer(IndexData);
+
+	uint32 Magic = HTTPResponseCache::IndexMagic;
+	int32 Version = HTTPResponseCache::IndexVersion;
+	Writer << Magic << Version;
+	Writer << MaxSizeBytes;
+	Writer << Entries;
+
+	if (!FFileHelper::SaveArrayToFile(IndexData, *(GetCacheDir() / TEXT("CacheIndex.bin"))))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FHTTPResponseCache::Failed to save CacheIndex.bin."));
+	}
+}
+
+void FHTTPResponseCache::MarkDirty()
+{
+	if (SaveTickerHandle.IsValid())
+	{
+		return;
+	}
+
+	SaveTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float DeltaTime)
+	{
+		// SaveIndex removes the ticker itself
+		FScopeLock Lock(&CacheLock);
+		SaveTickerHandle.Reset();
+		SaveIndex();
+		return false;
+	}), HTTPResponseCache::SaveDelay);
+}
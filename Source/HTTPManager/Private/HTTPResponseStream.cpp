@@ -0,0 +1,405 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPResponseStream.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+FHTTPResponseStream::FHTTPResponseStream()
+	: BytesReceived(0)
+{
+	SetIsSaving(true);
+	SetIsPersistent(false);
+}
+
+FHTTPResponseStream::~FHTTPResponseStream()
+{
+	// A stream that was never committed leaves nothing behind
+	if (FileWriter.IsValid())
+	{
+		Discard();
+	}
+}
+
+TSharedRef<FHTTPResponseStream> FHTTPResponseStream::CreateFileStream(const FString& TargetPath)
+{
+	TSharedRef<FHTTPResponseStream> Stream = MakeShareable(new FHTTPResponseStream());
+	Stream->bIsFileStream = true;
+	Stream->TargetPath = TargetPath;
+	Stream->PartPath = TargetPath + TEXT(".part");
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(TargetPath), true);
+	Stream->FileWriter.Reset(IFileManager::Get().CreateFileWriter(*Stream->PartPath));
+
+	if (!Stream->FileWriter.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPResponseStream::Failed to open %s for writing."), *Stream->PartPath);
+		Stream->SetError();
+	}
+
+	return Stream;
+}
+
+TSharedRef<FHTTPResponseStream> FHTTPResponseStream::CreateMemoryStream(int64 ExpectedSize)
+{
+	TSharedRef<FHTTPResponseStream> Stream = MakeShareable(new FHTTPResponseStream());
+	if (ExpectedSize > 0 && ExpectedSize <= MAX_int32)
+	{
+		Stream->Body.Reserve(static_cast<int32>(ExpectedSize));
+	}
+
+	return Stream;
+}
+
+bool FHTTPResponseStream::IsValid() const
+{
+	return (!bIsFileStream || FileWriter.IsValid()) && !IsError();
+}
+
+void FHTTPResponseStream::EnableContentDecoding(const FHttpRequestRef& Request)
+{
+	FScopeLock Lock(&WriterLock);
+
+	bDecodeContent = true;
+	DecodingRequest = Request;
+
+	// The queue chains its own header handler behind this one
+	TWeakPtr<FHTTPResponseStream, ESPMode::ThreadSafe> WeakStream = AsShared();
+	Request->OnHeaderReceived().BindLambda([WeakStream](FHttpRequestPtr HeaderRequest, const FString& HeaderName, const FString& HeaderValue)
+	{
+		TSharedPtr<FHTTPResponseStream, ESPMode::ThreadSafe> Stream = WeakStream.Pin();
+		if (Stream.IsValid() && HeaderName.Equals(TEXT("Content-Encoding"), ESearchCase::IgnoreCase))
+		{
+			FScopeLock StreamLock(&Stream->WriterLock);
+			Stream->SetContentEncoding(HeaderValue);
+		}
+	});
+}
+
+void FHTTPResponseStream::SetContentEncoding(const FString& ContentEncoding)
+{
+	if (bIsEncodingKnown)
+	{
+		return;
+	}
+
+	bIsEncodingKnown = true;
+	bIsEncoded = FHTTPContentDecoder::IsContentEncoded(ContentEncoding);
+}
+
+// Header callbacks may be broadcast from the game thread after the first chunk already arrived - the headers are complete by then
+void FHTTPResponseStream::ResolveContentEncoding()
+{
+	const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request = DecodingRequest.Pin();
+	const FHttpResponsePtr Response = Request.IsValid() ? Request->GetResponse() : nullptr;
+	SetContentEncoding(Response.IsValid() ? Response->GetHeader(TEXT("Content-Encoding")) : FString());
+}
+
+// Called on the HTTP thread for every received chunk
+void FHTTPResponseStream::Serialize(void* Data, int64 Num)
+{
+	if (Num <= 0)
+	{
+		return;
+	}
+
+	FScopeLock Lock(&WriterLock);
+
+	BytesReceived += Num;
+	const uint8* Bytes = static_cast<const uint8*>(Data);
+
+	if (bDecodeContent && !bIsEncodingKnown)
+	{
+		ResolveContentEncoding();
+	}
+
+	if (!bDecodeContent || !bIsEncoded)
+	{
+		WriteBody(Bytes, Num);
+		return;
+	}
+
+	// The first bytes decide whether the body is compressed at all - the HTTP backend may have decoded it already
+	if (!bIsSniffed)
+	{
+		const int32 Held = SniffBuffer.Num();
+		if (Held + Num < FHTTPContentDecoder::MinSniffSize)
+		{
+			SniffBuffer.Append(Bytes, static_cast<int32>(Num));
+			return;
+		}
+
+		uint8 Head[FHTTPContentDecoder::MinSniffSize];
+		FMemory::Memcpy(Head, SniffBuffer.GetData(), Held);
+		FMemory::Memcpy(Head + Held, Bytes, FHTTPContentDecoder::MinSniffSize - Held);
+
+		bIsSniffed = true;
+		if (FHTTPContentDecoder::IsCompressed(Head, FHTTPContentDecoder::MinSniffSize))
+		{
+			Decoder = MakeUnique<FHTTPContentDecoder>();
+		}
+
+		if (Held > 0)
+		{
+			TArray<uint8> HeldBytes = MoveTemp(SniffBuffer);
+			ConsumeBody(HeldBytes.GetData(), HeldBytes.Num());
+		}
+	}
+
+	ConsumeBody(Bytes, Num);
+}
+
+void FHTTPResponseStream::ConsumeBody(const uint8* Data, int64 Num)
+{
+	if (!Decoder.IsValid())
+	{
+		WriteBody(Data, Num);
+		return;
+	}
+
+	const bool bIsDecoded = Decoder->Decode(Data, Num, [this](const uint8* Decoded, int64 DecodedNum)
+	{
+		return WriteBody(Decoded, DecodedNum);
+	});
+
+	if (!bIsDecoded)
+	{
+		SetError();
+	}
+}
+
+bool FHTTPResponseStream::WriteBody(const uint8* Data, int64 Num)
+{
+	if (IsError())
+	{
+		return false;
+	}
+
+	if (Hasher.IsValid())
+	{
+		Hasher->Update(Data, Num);
+	}
+
+	if (!bIsFileStream)
+	{
+		if (Body.Num() + Num > MAX_int32)
+		{
+			UE_LOG(LogTemp, Error, TEXT("FHTTPResponseStream::Body exceeds the in-memory limit - use a file stream instead."));
+			SetError();
+			return false;
+		}
+
+		Body.Append(Data, static_cast<int32>(Num));
+		return true;
+	}
+
+	if (!FileWriter.IsValid() || FileWriter->IsError())
+	{
+		SetError();
+		return false;
+	}
+
+	FileWriter->Serialize(const_cast<uint8*>(Data), Num);
+	if (FileWriter->IsError())
+	{
+		SetError();
+		return false;
+	}
+
+	return true;
+}
+
+// Flushes a body too short to sniff and makes sure a compressed body wasn't cut off
+void FHTTPResponseStream::FinishDecoding()
+{
+	if (!bIsSniffed && SniffBuffer.Num() > 0)
+	{
+		bIsSniffed = true;
+		TArray<uint8> HeldBytes = MoveTemp(SniffBuffer);
+		WriteBody(HeldBytes.GetData(), HeldBytes.Num());
+	}
+
+	if (Decoder.IsValid() && !Decoder->IsFinished() && !IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPResponseStream::Compressed body ended before the end of its stream."));
+		SetError();
+	}
+}
+
+bool FHTTPResponseStream::Close()
+{
+	FScopeLock Lock(&WriterLock);
+
+	FinishDecoding();
+
+	if (FileWriter.IsValid())
+	{
+		FileWriter->Flush();
+		if (!FileWriter->Close())
+		{
+			SetError();
+		}
+		FileWriter.Reset();
+	}
+
+	return !IsError();
+}
+
+void FHTTPResponseStream::SetExpectedHash(EHTTPHashAlgorithm Algorithm, const FString& InExpectedHash, int64 BlobSize)
+{
+	FScopeLock Lock(&WriterLock);
+
+	// The blob header carries the size - without one the body is hashed once it is complete
+	bIsHashDeferred = Algorithm == EHTTPHashAlgorithm::GitBlobSHA1 && BlobSize < 0;
+	Hasher.Reset(Algorithm != EHTTPHashAlgorithm::None && !bIsHashDeferred ? new FHTTPStreamHasher(Algorithm, BlobSize) : nullptr);
+	ExpectedHash = InExpectedHash;
+	ComputedHash.Reset();
+}
+
+bool FHTTPResponseStream::VerifyHash()
+{
+	FScopeLock Lock(&WriterLock);
+
+	if (bIsHashDeferred)
+	{
+		ComputedHash = HashWrittenBlob();
+	}
+	else if (Hasher.IsValid())
+	{
+		ComputedHash = Hasher->Finalize();
+	}
+	else
+	{
+		return true;
+	}
+
+	if (FHTTPStreamHasher::Matches(ComputedHash, ExpectedHash))
+	{
+		return true;
+	}
+
+	UE_LOG(LogTemp, Error, TEXT("FHTTPResponseStream::Hash mismatch for %s - expected %s, received %s."),
+		bIsFileStream ? *TargetPath : TEXT("in-memory body"), *ExpectedHash, *ComputedHash);
+	SetError();
+	return false;
+}
+
+FString FHTTPResponseStream::HashWrittenBlob() const
+{
+	if (!bIsFileStream)
+	{
+		FHTTPStreamHasher BlobHasher(EHTTPHashAlgorithm::GitBlobSHA1, Body.Num());
+		BlobHasher.Update(Body.GetData(), Body.Num());
+		return BlobHasher.Finalize();
+	}
+
+	// The writer is closed by now - read the ".part" file back in chunks
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*PartPath));
+	if (!Reader.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPResponseStream::Failed to reopen %s for hashing."), *PartPath);
+		return FString();
+	}
+
+	const int64 FileSize = Reader->TotalSize();
+	FHTTPStreamHasher BlobHasher(EHTTPHashAlgorithm::GitBlobSHA1, FileSize);
+
+	TArray<uint8> Chunk;
+	Chunk.SetNumUninitialized(64 * 1024);
+	for (int64 Offset = 0; Offset < FileSize; )
+	{
+		const int64 ChunkSize = FMath::Min<int64>(Chunk.Num(), FileSize - Offset);
+		Reader->Serialize(Chunk.GetData(), ChunkSize);
+		if (Reader->IsError())
+		{
+			UE_LOG(LogTemp, Error, TEXT("FHTTPResponseStream::Failed to read %s for hashing."), *PartPath);
+			return FString();
+		}
+
+		BlobHasher.Update(Chunk.GetData(), ChunkSize);
+		Offset += ChunkSize;
+	}
+
+	return BlobHasher.Finalize();
+}
+
+bool FHTTPResponseStream::Commit()
+{
+	if (!bIsFileStream)
+	{
+		return Close() && VerifyHash();
+	}
+
+	if (!Close() || !VerifyHash())
+	{
+		IFileManager::Get().Delete(*PartPath, false, true, true);
+		return false;
+	}
+
+	// Replace the existing target only now that the whole body is on disk
+	if (!IFileManager::Get().Move(*TargetPath, *PartPath, true, true))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPResponseStream::Failed to move %s to %s."), *PartPath, *TargetPath);
+		IFileManager::Get().Delete(*PartPath, false, true, true);
+		return false;
+	}
+
+	return true;
+}
+
+void FHTTPResponseStream::Discard()
+{
+	if (!bIsFileStream)
+	{
+		FScopeLock Lock(&WriterLock);
+		Body.Empty();
+		return;
+	}
+
+	Close();
+	IFileManager::Get().Delete(*PartPath, false, true, true);
+}
+
+bool FHTTPResponseStream::Restart()
+{
+	FScopeLock Lock(&WriterLock);
+
+	ClearError();
+	BytesReceived = 0;
+
+	bIsEncodingKnown = false;
+	bIsEncoded = false;
+	bIsSniffed = false;
+	SniffBuffer.Reset();
+	Decoder.Reset();
+
+	if (Hasher.IsValid())
+	{
+		Hasher->Reset();
+	}
+	ComputedHash.Reset();
+
+	if (!bIsFileStream)
+	{
+		Body.Reset();
+		return true;
+	}
+
+	FileWriter.Reset();
+	FileWriter.Reset(IFileManager::Get().CreateFileWriter(*PartPath));
+	if (!FileWriter.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPResponseStream::Failed to reopen %s for writing."), *PartPath);
+		SetError();
+		return false;
+	}
+
+	return true;
+}
+
+TArray<uint8> FHTTPResponseStream::ReleaseBody()
+{
+	FScopeLock Lock(&WriterLock);
+	return MoveTemp(Body);
+}
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPRetryPolicy.h"
+
+#include "Misc/DateTime.h"
+
+FHTTPRetryPolicy FHTTPRetryPolicy::NoRetry()
+{
+	FHTTPRetryPolicy Policy;
+	Policy.MaxAttempts = 1;
+	return Policy;
+}
+
+bool FHTTPRetryPolicy::IsTransientError(int32 ResponseCode)
+{
+	switch (ResponseCode)
+	{
+		case EHttpResponseCodes::TooManyRequests:
+		case EHttpResponseCodes::ServerError:
+		case EHttpResponseCodes::BadGateway:
+		case EHttpResponseCodes::ServiceUnavail:
+		case EHttpResponseCodes::GatewayTimeout:
+			return true;
+		default:
+			return false;
+	}
+}
+
+double FHTTPRetryPolicy::GetRateLimitWait(const FHttpResponsePtr& Response)
+{
+	if (!Response.IsValid())
+	{
+		return 0.0;
+	}
+
+	// Secondary rate limits and 429/503 - either delta seconds or an HTTP date
+	const FString RetryAfter = Response->GetHeader(TEXT("Retry-After"));
+	if (!RetryAfter.IsEmpty())
+	{
+		if (RetryAfter.IsNumeric())
+		{
+			return FMath::Max(FCString::Atod(*RetryAfter), 0.0);
+		}
+
+		FDateTime RetryAt;
+		if (FDateTime::ParseHttpDate(RetryAfter, RetryAt))
+		{
+			return FMath::Max((RetryAt - FDateTime::UtcNow()).GetTotalSeconds(), 0.0);
+		}
+	}
+
+	// Primary rate limit - nothing left until the window resets (Unix seconds)
+	const FString Remaining = Response->GetHeader(TEXT("X-RateLimit-Remaining"));
+	const FString Reset = Response->GetHeader(TEXT("X-RateLimit-Reset"));
+	if (Remaining == TEXT("0") && Reset.IsNumeric())
+	{
+		const int64 ResetAt = FCString::Atoi64(*Reset);
+		// One extra second - the reset timestamp is truncated
+		return FMath::Max<double>(ResetAt - FDateTime::UtcNow().ToUnixTimestamp() + 1, 0.0);
+	}
+
+	return 0.0;
+}
+
+double FHTTPRetryPolicy::GetRetryDelay(int32 AttemptsMade, const FHttpResponsePtr& Response, bool bWasSuccessful) const
+{
+	if (AttemptsMade >= MaxAttempts)
+	{
+		return -1.0;
+	}
+
+	const int32 ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
+	const double RateLimitWait = GetRateLimitWait(Response);
+
+	// GitHub answers an exhausted rate limit with 403 - only worth retrying once the window resets
+	const bool bIsRateLimited = ResponseCode == EHttpResponseCodes::Denied && RateLimitWait > 0.0;
+	const bool bIsConnectionError = !bWasSuccessful || !Response.IsValid();
+
+	if (!bIsConnectionError && !bIsRateLimited && !IsTransientError(ResponseCode))
+	{
+		return -1.0;
+	}
+
+	// Equal jitter - half the backoff is fixed, the other half random, so parallel retries don't line up
+	const double Backoff = FMath::Min<double>(BaseDelay * FMath::Pow(2.0f, static_cast<float>(AttemptsMade - 1)), MaxDelay);
+	const double Jittered = Backoff * 0.5 + FMath::FRandRange(0.0, Backoff * 0.5);
+
+	return FMath::Max(Jittered, RateLimitWait);
+}
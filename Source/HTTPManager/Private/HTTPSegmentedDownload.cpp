@@ -0,0 +1,512 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPSegmentedDownload.h"
+#include "HTTPRequestQueue.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+// JSON
+#include "Json.h"
+
+// Receives the body of a single range request and forwards it to its slot in the shared part file;
+// The first chunk checks the response - an error page or a 200 ignoring the range never reaches the slot;
+class FHTTPSegmentStream : public FArchive
+{
+	public:
+
+	FHTTPSegmentStream(const TSharedRef<FHTTPSegmentedDownload, ESPMode::ThreadSafe>& InOwner, int32 InSegmentIndex, const FHttpRequestRef& InRequest, int64 InOffset)
+		: Owner(InOwner)
+		, SegmentIndex(InSegmentIndex)
+		, Request(InRequest)
+		, Offset(InOffset)
+	{
+		SetIsSaving(true);
+	}
+
+	virtual void Serialize(void* Data, int64 Num) override
+	{
+		if (Num <= 0 || IsError())
+		{
+			return;
+		}
+
+		if (!bIsChecked)
+		{
+			bIsChecked = true;
+			if (!IsRequestedRange())
+			{
+				SetError();
+				return;
+			}
+		}
+
+		if (!Owner->WriteSegmentChunk(SegmentIndex, Offset, Data, Num))
+		{
+			SetError();
+			return;
+		}
+		Offset += Num;
+	}
+
+	virtual FString GetArchiveName() const override { return TEXT("FHTTPSegmentStream"); }
+
+	private:
+
+	// The headers are complete once body bytes arrive - "Content-Range: bytes <Offset>-<End>/<Total>"
+	bool IsRequestedRange() const
+	{
+		const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> PinnedRequest = Request.Pin();
+		const FHttpResponsePtr Response = PinnedRequest.IsValid() ? PinnedRequest->GetResponse() : nullptr;
+		if (!Response.IsValid() || Response->GetResponseCode() != EHttpResponseCodes::PartialContent)
+		{
+			return false;
+		}
+
+		FString RangeStart;
+		if (!Response->GetHeader(TEXT("Content-Range")).TrimStartAndEnd().Split(TEXT("-"), &RangeStart, nullptr))
+		{
+			return false;
+		}
+		RangeStart.RemoveFromStart(TEXT("bytes "));
+
+		int64 Start = INDEX_NONE;
+		return LexTryParseString(Start, *RangeStart) && Start == Offset;
+	}
+
+	TSharedRef<FHTTPSegmentedDownload, ESPMode::ThreadSafe> Owner;
+	int32 SegmentIndex;
+	TWeakPtr<IHttpRequest, ESPMode::ThreadSafe> Request;
+	int64 Offset;
+	bool bIsChecked = false;
+};
+
+TSharedRef<FHTTPSegmentedDownload, ESPMode::ThreadSafe> FHTTPSegmentedDownload::Create(const FString& URL, const FString& TargetPath, const FHTTPSegmentedSettings& Settings)
+{
+	TSharedRef<FHTTPSegmentedDownload, ESPMode::ThreadSafe> Download = MakeShareable(new FHTTPSegmentedDownload());
+	Download->URL = URL;
+	Download->TargetPath = TargetPath;
+	Download->PartPath = TargetPath + TEXT(".part");
+	Download->SidecarPath = Download->PartPath + TEXT(".json");
+	Download->Settings = Settings;
+	Download->Settings.SegmentCount = FMath::Clamp(Settings.SegmentCount, 1, 16);
+	Download->CancellationToken = Settings.CancellationToken.IsValid() ? Settings.CancellationToken->CreateChild() : FHTTPCancellationToken::Create();
+
+	return Download;
+}
+
+FHTTPSegmentedDownload::~FHTTPSegmentedDownload()
+{
+	if (SaveTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(SaveTickerHandle);
+	}
+}
+
+int32 FHTTPSegmentedDownload::Start(FHTTPSegmentedCompleteFunc InOnComplete)
+{
+	OnComplete = MoveTemp(InOnComplete);
+
+	TSharedRef<FHTTPSegmentedDownload, ESPMode::ThreadSafe> This = AsShared();
+	return FHTTPRequestQueue::Get().Enqueue(URL, nullptr,
+		[This](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+		{
+			This->OnProbeComplete(Request, Response, bWasSuccessful);
+		},
+		MakeRequestOptions(TEXT("HEAD")));
+}
+
+void FHTTPSegmentedDownload::Cancel()
+{
+	CancellationToken->Cancel();
+}
+
+FHTTPRequestOptions FHTTPSegmentedDownload::MakeRequestOptions(const FString& Verb) const
+{
+	FHTTPRequestOptions Options;
+	Options.Verb = Verb;
+	Options.Priority = Settings.Priority;
+	Options.CancellationToken = CancellationToken;
+	// Segments are written straight into the target file
+	Options.bBuffersBody = false;
+	return Options;
+}
+
+int64 FHTTPSegmentedDownload::GetBytesReceived() const
+{
+	FScopeLock Lock(&FileLock);
+
+	int64 BytesReceived = 0;
+	for (const FSegment& Segment : Segments)
+	{
+		BytesReceived += Segment.Written;
+	}
+	return BytesReceived;
+}
+
+void FHTTPSegmentedDownload::OnProbeComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	// A cancelled download must not fall back to a single request
+	if (CancellationToken->IsCancelled())
+	{
+		Finish(EHTTPSegmentedResult::Failed);
+		return;
+	}
+
+	// Servers rejecting HEAD are simply downloaded in one piece
+	if (!bWasSuccessful || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		Finish(EHTTPSegmentedResult::Unsupported);
+		return;
+	}
+
+	const bool bAcceptsRanges = Response->GetHeader(TEXT("Accept-Ranges")).Equals(TEXT("bytes"), ESearchCase::IgnoreCase);
+	const bool bIsEncoded = !Response->GetHeader(TEXT("Content-Encoding")).IsEmpty();
+	LexFromString(TotalSize, *Response->GetHeader(TEXT("Content-Length")));
+
+	if (!bAcceptsRanges || bIsEncoded || TotalSize < FMath::Max<int64>(Settings.MinSegmentedSize, 1))
+	{
+		Finish(EHTTPSegmentedResult::Unsupported);
+		return;
+	}
+
+	Validator = Response->GetHeader(TEXT("ETag"));
+	if (Validator.IsEmpty())
+	{
+		Validator = Response->GetHeader(TEXT("Last-Modified"));
+	}
+
+	// Resume only into a part file of the very same resource
+	const bool bResume = LoadSidecar();
+	if (!bResume)
+	{
+		BuildSegments();
+	}
+
+	if (!OpenPartFile(bResume))
+	{
+		Finish(EHTTPSegmentedResult::Failed);
+		return;
+	}
+
+	SaveSidecar();
+
+	TWeakPtr<FHTTPSegmentedDownload, ESPMode::ThreadSafe> WeakThis = AsShared();
+	SaveTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis](float DeltaTime)
+	{
+		if (TSharedPtr<FHTTPSegmentedDownload, ESPMode::ThreadSafe> This = WeakThis.Pin())
+		{
+			This->SaveSidecar();
+			return true;
+		}
+		return false;
+	}), Settings.ProgressSaveInterval);
+
+	UE_LOG(LogTemp, Log, TEXT("FHTTPSegmentedDownload::%s - %lld bytes in %d segments%s."), *URL, TotalSize, Segments.Num(), bResume ? TEXT(" (resumed)") : TEXT(""));
+
+	for (int32 Index = 0; Index < Segments.Num(); ++Index)
+	{
+		StartSegment(Index);
+	}
+
+	// Everything was already on disk
+	if (NumInFlight == 0)
+	{
+		Finish(EHTTPSegmentedResult::Succeeded);
+	}
+}
+
+void FHTTPSegmentedDownload::BuildSegments()
+{
+	FScopeLock Lock(&FileLock);
+
+	Segments.Reset();
+
+	const int64 SegmentSize = FMath::DivideAndRoundUp(TotalSize, static_cast<int64>(Settings.SegmentCount));
+	for (int64 Start = 0; Start < TotalSize; Start += SegmentSize)
+	{
+		FSegment& Segment = Segments.AddDefaulted_GetRef();
+		Segment.Start = Start;
+		Segment.End = FMath::Min(Start + SegmentSize, TotalSize) - 1;
+	}
+}
+
+void FHTTPSegmentedDownload::StartSegment(int32 SegmentIndex)
+{
+	{
+		FScopeLock Lock(&FileLock);
+
+		FSegment& Segment = Segments[SegmentIndex];
+		if (Segment.IsDone())
+		{
+			return;
+		}
+
+		Segment.bIsInFlight = true;
+	}
+
+	NumInFlight++;
+
+	TSharedRef<FHTTPSegmentedDownload, ESPMode::ThreadSafe> This = AsShared();
+	FHTTPRequestQueue::Get().Enqueue(URL,
+		[This, SegmentIndex](const FHttpRequestRef& Request)
+		{
+			FString Range;
+			const int64 Offset = This->PrepareSegmentRequest(SegmentIndex, Range);
+			if (Offset == INDEX_NONE)
+			{
+				return false;
+			}
+
+			Request->SetHeader(TEXT("Range"), Range);
+			return Request->SetResponseBodyReceiveStream(MakeShared<FHTTPSegmentStream>(This, SegmentIndex, Request, Offset));
+		},
+		[This, SegmentIndex](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+		{
+			This->OnSegmentComplete(SegmentIndex, Response, bWasSuccessful);
+		},
+		MakeRequestOptions(TEXT("GET")));
+}
+
+// Runs for every attempt - a retry continues where the previous attempt of the segment stopped
+int64 FHTTPSegmentedDownload::PrepareSegmentRequest(int32 SegmentIndex, FString& OutRange)
+{
+	FScopeLock Lock(&FileLock);
+
+	// The previous attempt received everything before it failed
+	const FSegment& Segment = Segments[SegmentIndex];
+	if (Segment.IsDone())
+	{
+		return INDEX_NONE;
+	}
+
+	const int64 Offset = Segment.Start + Segment.Written;
+	OutRange = FString::Printf(TEXT("bytes=%lld-%lld"), Offset, Segment.End);
+	return Offset;
+}
+
+bool FHTTPSegmentedDownload::WriteSegmentChunk(int32 SegmentIndex, int64 Offset, const void* Data, int64 Num)
+{
+	FScopeLock Lock(&FileLock);
+
+	if (!FileHandle.IsValid() || !Segments.IsValidIndex(SegmentIndex))
+	{
+		return false;
+	}
+
+	FSegment& Segment = Segments[SegmentIndex];
+
+	// A stale attempt or a server overrunning the range would overwrite the neighbouring segment
+	if (Offset != Segment.Start + Segment.Written || Segment.Written + Num > Segment.GetLength())
+	{
+		return false;
+	}
+
+	if (!FileHandle->Seek(Segment.Start + Segment.Written) || !FileHandle->Write(static_cast<const uint8*>(Data), Num))
+	{
+		return false;
+	}
+
+	Segment.Written += Num;
+	return true;
+}
+
+void FHTTPSegmentedDownload::OnSegmentComplete(int32 SegmentIndex, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	NumInFlight--;
+
+	// The stream only lets bytes of the requested range through - whatever was written stays valid, even if the attempt failed
+	bool bIsSegmentDone = false;
+	int64 Written = 0;
+	{
+		FScopeLock Lock(&FileLock);
+
+		FSegment& Segment = Segments[SegmentIndex];
+		Segment.bIsInFlight = false;
+		bIsSegmentDone = Segment.IsDone();
+		Written = Segment.Written;
+	}
+
+	if (!bIsSegmentDone)
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPSegmentedDownload::Segment %d of %s failed (%d) after %lld bytes - progress is kept for resuming."),
+			SegmentIndex, *URL, Response.IsValid() ? Response->GetResponseCode() : 0, Written);
+		bHasFailed = true;
+	}
+
+	SaveSidecar();
+
+	if (NumInFlight == 0)
+	{
+		Finish(bHasFailed ? EHTTPSegmentedResult::Failed : EHTTPSegmentedResult::Succeeded);
+	}
+}
+
+bool FHTTPSegmentedDownload::OpenPartFile(bool bResume)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(PartPath));
+
+	FScopeLock Lock(&FileLock);
+
+	// Resuming keeps the existing bytes, a fresh download truncates
+	FileHandle.Reset(PlatformFile.OpenWrite(*PartPath, bResume, true));
+	if (!FileHandle.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPSegmentedDownload::Failed to open %s for writing."), *PartPath);
+		return false;
+	}
+
+	// Preallocate - every segment writes into its own slot of the final file
+	if (FileHandle->Size() != TotalSize)
+	{
+		const uint8 Zero = 0;
+		if (!FileHandle->Seek(TotalSize - 1) || !FileHandle->Write(&Zero, 1))
+		{
+			UE_LOG(LogTemp, Error, TEXT("FHTTPSegmentedDownload::Failed to preallocate %lld bytes for %s."), TotalSize, *PartPath);
+			FileHandle.Reset();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// The sidecar is trusted only if it describes the same URL, size and validator and the part file is still there
+bool FHTTPSegmentedDownload::LoadSidecar()
+{
+	FString JsonString;
+	if (!IFileManager::Get().FileExists(*PartPath) || !FFileHelper::LoadFileToString(JsonString, *SidecarPath))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Sidecar;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+	if (!FJsonSerializer::Deserialize(Reader, Sidecar) || !Sidecar.IsValid())
+	{
+		return false;
+	}
+
+	if (Sidecar->GetStringField(TEXT("URL")) != URL
+		|| Sidecar->GetStringField(TEXT("Validator")) != Validator
+		|| static_cast<int64>(Sidecar->GetNumberField(TEXT("TotalSize"))) != TotalSize
+		|| IFileManager::Get().FileSize(*PartPath) != TotalSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FHTTPSegmentedDownload::%s changed since the last attempt - starting over."), *URL);
+		return false;
+	}
+
+	TArray<FSegment> LoadedSegments;
+	for (const TSharedPtr<FJsonValue>& Value : Sidecar->GetArrayField(TEXT("Segments")))
+	{
+		const TSharedPtr<FJsonObject> SegmentObject = Value->AsObject();
+		if (!SegmentObject.IsValid())
+		{
+			return false;
+		}
+
+		FSegment& Segment = LoadedSegments.AddDefaulted_GetRef();
+		Segment.Start = static_cast<int64>(SegmentObject->GetNumberField(TEXT("Start")));
+		Segment.End = static_cast<int64>(SegmentObject->GetNumberField(TEXT("End")));
+		Segment.Written = FMath::Clamp(static_cast<int64>(SegmentObject->GetNumberField(TEXT("Written"))), static_cast<int64>(0), Segment.GetLength());
+	}
+
+	if (LoadedSegments.IsEmpty())
+	{
+		return false;
+	}
+
+	FScopeLock Lock(&FileLock);
+	Segments = MoveTemp(LoadedSegments);
+	return true;
+}
+
+void FHTTPSegmentedDownload::SaveSidecar()
+{
+	if (bIsFinished)
+	{
+		return;
+	}
+
+	TSharedPtr<FJsonObject> Sidecar = MakeShareable(new FJsonObject());
+	Sidecar->SetStringField(TEXT("URL"), URL);
+	Sidecar->SetStringField(TEXT("Validator"), Validator);
+	Sidecar->SetNumberField(TEXT("TotalSize"), static_cast<double>(TotalSize));
+
+	TArray<TSharedPtr<FJsonValue>> SegmentArray;
+	{
+		FScopeLock Lock(&FileLock);
+
+		// Bytes reported as written must really be on disk before the sidecar claims them
+		if (FileHandle.IsValid())
+		{
+			FileHandle->Flush();
+		}
+
+		for (const FSegment& Segment : Segments)
+		{
+			TSharedPtr<FJsonObject> SegmentObject = MakeShareable(new FJsonObject());
+			SegmentObject->SetNumberField(TEXT("Start"), static_cast<double>(Segment.Start));
+			SegmentObject->SetNumberField(TEXT("End"), static_cast<double>(Segment.End));
+			SegmentObject->SetNumberField(TEXT("Written"), static_cast<double>(Segment.Written));
+			SegmentArray.Add(MakeShareable(new FJsonValueObject(SegmentObject)));
+		}
+	}
+	Sidecar->SetArrayField(TEXT("Segments"), SegmentArray);
+
+	FString OutputString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
+	if (FJsonSerializer::Serialize(Sidecar.ToSharedRef(), Writer))
+	{
+		FFileHelper::SaveStringToFile(OutputString, *SidecarPath);
+	}
+}
+
+void FHTTPSegmentedDownload::Finish(EHTTPSegmentedResult Result)
+{
+	if (bIsFinished)
+	{
+		return;
+	}
+
+	if (SaveTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(SaveTickerHandle);
+		SaveTickerHandle.Reset();
+	}
+
+	// Failed downloads keep the part file and sidecar for the next attempt
+	if (Result == EHTTPSegmentedResult::Failed)
+	{
+		SaveSidecar();
+	}
+
+	bIsFinished = true;
+
+	{
+		FScopeLock Lock(&FileLock);
+		FileHandle.Reset();
+	}
+
+	if (Result == EHTTPSegmentedResult::Succeeded)
+	{
+		if (IFileManager::Get().Move(*TargetPath, *PartPath, true, true))
+		{
+			IFileManager::Get().Delete(*SidecarPath, false, true, true);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("FHTTPSegmentedDownload::Failed to move %s to %s."), *PartPath, *TargetPath);
+			Result = EHTTPSegmentedResult::Failed;
+		}
+	}
+
+	if (OnComplete)
+	{
+		FHTTPSegmentedCompleteFunc Callback = MoveTemp(OnComplete);
+		Callback(Result, GetBytesReceived());
+	}
+}
@@ -0,0 +1,230 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPStreamHasher.h"
+
+namespace HTTPStreamHasher
+{
+	constexpr uint32 RoundConstants[64] =
+	{
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+
+	FORCEINLINE uint32 RotateRight(uint32 Value, uint32 Bits)
+	{
+		return (Value >> Bits) | (Value << (32 - Bits));
+	}
+
+	FString ToHex(const uint8* Digest, int32 Num)
+	{
+		FString HashString;
+		HashString.Reserve(Num * 2);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			HashString += FString::Printf(TEXT("%02x"), Digest[Index]);
+		}
+
+		return HashString;
+	}
+}
+
+void FHTTPSHA256::Reset()
+{
+	State[0] = 0x6a09e667;
+	State[1] = 0xbb67ae85;
+	State[2] = 0x3c6ef372;
+	State[3] = 0xa54ff53a;
+	State[4] = 0x510e527f;
+	State[5] = 0x9b05688c;
+	State[6] = 0x1f83d9ab;
+	State[7] = 0x5be0cd19;
+
+	TotalBytes = 0;
+	BlockSize = 0;
+}
+
+void FHTTPSHA256::Update(const uint8* Data, int64 Num)
+{
+	TotalBytes += Num;
+
+	// Top up a partial block first, then hash whole blocks straight from the input
+	if (BlockSize > 0)
+	{
+		const int32 Fill = static_cast<int32>(FMath::Min<int64>(64 - BlockSize, Num));
+		FMemory::Memcpy(Block + BlockSize, Data, Fill);
+		BlockSize += Fill;
+		Data += Fill;
+		Num -= Fill;
+
+		if (BlockSize < 64)
+		{
+			return;
+		}
+
+		Transform(Block);
+		BlockSize = 0;
+	}
+
+	while (Num >= 64)
+	{
+		Transform(Data);
+		Data += 64;
+		Num -= 64;
+	}
+
+	if (Num > 0)
+	{
+		FMemory::Memcpy(Block, Data, Num);
+		BlockSize = static_cast<int32>(Num);
+	}
+}
+
+void FHTTPSHA256::Final(uint8* OutDigest)
+{
+	const uint64 TotalBits = TotalBytes * 8;
+
+	// 0x80, zeros up to 56 mod 64, then the message length in bits as big endian
+	uint8 Padding[72] = { 0x80 };
+	const int32 PaddingSize = BlockSize < 56 ? 56 - BlockSize : 120 - BlockSize;
+	for (int32 Index = 0; Index < 8; ++Index)
+	{
+		Padding[PaddingSize + Index] = static_cast<uint8>(TotalBits >> (56 - Index * 8));
+	}
+	Update(Padding, PaddingSize + 8);
+
+	for (int32 Index = 0; Index < 8; ++Index)
+	{
+		OutDigest[Index * 4 + 0] = static_cast<uint8>(State[Index] >> 24);
+		OutDigest[Index * 4 + 1] = static_cast<uint8>(State[Index] >> 16);
+		OutDigest[Index * 4 + 2] = static_cast<uint8>(State[Index] >> 8);
+		OutDigest[Index * 4 + 3] = static_cast<uint8>(State[Index]);
+	}
+}
+
+void FHTTPSHA256::Transform(const uint8* Data)
+{
+	using namespace HTTPStreamHasher;
+
+	uint32 Schedule[64];
+	for (int32 Index = 0; Index < 16; ++Index)
+	{
+		Schedule[Index] = (uint32(Data[Index * 4]) << 24) | (uint32(Data[Index * 4 + 1]) << 16) | (uint32(Data[Index * 4 + 2]) << 8) | uint32(Data[Index * 4 + 3]);
+	}
+	for (int32 Index = 16; Index < 64; ++Index)
+	{
+		const uint32 S0 = RotateRight(Schedule[Index - 15], 7) ^ RotateRight(Schedule[Index - 15], 18) ^ (Schedule[Index - 15] >> 3);
+		const uint32 S1 = RotateRight(Schedule[Index - 2], 17) ^ RotateRight(Schedule[Index - 2], 19) ^ (Schedule[Index - 2] >> 10);
+		Schedule[Index] = Schedule[Index - 16] + S0 + Schedule[Index - 7] + S1;
+	}
+
+	uint32 A = State[0], B = State[1], C = State[2], D = State[3];
+	uint32 E = State[4], F = State[5], G = State[6], H = State[7];
+
+	for (int32 Index = 0; Index < 64; ++Index)
+	{
+		const uint32 S1 = RotateRight(E, 6) ^ RotateRight(E, 11) ^ RotateRight(E, 25);
+		const uint32 Choice = (E & F) ^ (~E & G);
+		const uint32 Temp1 = H + S1 + Choice + RoundConstants[Index] + Schedule[Index];
+		const uint32 S0 = RotateRight(A, 2) ^ RotateRight(A, 13) ^ RotateRight(A, 22);
+		const uint32 Majority = (A & B) ^ (A & C) ^ (B & C);
+		const uint32 Temp2 = S0 + Majority;
+
+		H = G;
+		G = F;
+		F = E;
+		E = D + Temp1;
+		D = C;
+		C = B;
+		B = A;
+		A = Temp1 + Temp2;
+	}
+
+	State[0] += A;
+	State[1] += B;
+	State[2] += C;
+	State[3] += D;
+	State[4] += E;
+	State[5] += F;
+	State[6] += G;
+	State[7] += H;
+}
+
+FHTTPStreamHasher::FHTTPStreamHasher(EHTTPHashAlgorithm InAlgorithm, int64 InBlobSize)
+	: Algorithm(InAlgorithm)
+	, BlobSize(InBlobSize)
+{
+	Reset();
+}
+
+void FHTTPStreamHasher::Reset()
+{
+	MD5 = FMD5();
+	SHA1.Reset();
+	SHA256.Reset();
+
+	// Git hashes the object header together with the content
+	if (Algorithm == EHTTPHashAlgorithm::GitBlobSHA1)
+	{
+		const FTCHARToUTF8 Header(*FString::Printf(TEXT("blob %lld"), BlobSize));
+		SHA1.Update(reinterpret_cast<const uint8*>(Header.Get()), Header.Length() + 1);
+	}
+}
+
+void FHTTPStreamHasher::Update(const uint8* Data, int64 Num)
+{
+	switch (Algorithm)
+	{
+		case EHTTPHashAlgorithm::MD5:
+			MD5.Update(Data, static_cast<uint64>(Num));
+			break;
+
+		case EHTTPHashAlgorithm::SHA1:
+		case EHTTPHashAlgorithm::GitBlobSHA1:
+			SHA1.Update(Data, static_cast<uint64>(Num));
+			break;
+
+		case EHTTPHashAlgorithm::SHA256:
+			SHA256.Update(Data, Num);
+			break;
+
+		default:
+			break;
+	}
+}
+
+FString FHTTPStreamHasher::Finalize()
+{
+	uint8 Digest[FHTTPSHA256::DigestSize];
+
+	switch (Algorithm)
+	{
+		case EHTTPHashAlgorithm::MD5:
+			MD5.Final(Digest);
+			return HTTPStreamHasher::ToHex(Digest, 16);
+
+		case EHTTPHashAlgorithm::SHA1:
+		case EHTTPHashAlgorithm::GitBlobSHA1:
+			SHA1.Final();
+			SHA1.GetHash(Digest);
+			return HTTPStreamHasher::ToHex(Digest, FSHA1::DigestSize);
+
+		case EHTTPHashAlgorithm::SHA256:
+			SHA256.Final(Digest);
+			return HTTPStreamHasher::ToHex(Digest, FHTTPSHA256::DigestSize);
+
+		default:
+			return FString();
+	}
+}
+
+bool FHTTPStreamHasher::Matches(const FString& ComputedHash, const FString& ExpectedHash)
+{
+	return ExpectedHash.IsEmpty() || ComputedHash.Equals(ExpectedHash.TrimStartAndEnd(), ESearchCase::IgnoreCase);
+}
@@ -0,0 +1,237 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPZipExtractor.h"
+#include "HTTPContentDecoder.h"
+#include "HTTPZipMemoryStream.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// ZIP
+#include "mz.h"
+#include "mz_strm.h"
+#include "mz_zip.h"
+#include "mz_zip_rw.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace HTTPZipExtractor
+{
+	static const uint32 LocalHeaderSignature = 0x04034b50;
+	static const int64 LocalHeaderSize = 30;
+
+	static uint16 ReadUInt16(const uint8* Data)
+	{
+		return static_cast<uint16>(Data[0] | (Data[1] << 8));
+	}
+
+	static uint32 ReadUInt32(const uint8* Data)
+	{
+		return static_cast<uint32>(Data[0]) | (static_cast<uint32>(Data[1]) << 8) | (static_cast<uint32>(Data[2]) << 16) | (static_cast<uint32>(Data[3]) << 24);
+	}
+
+	// The local header may carry a different extra field than the central directory - its own lengths decide where the data starts
+	static int64 GetEntryDataOffset(const TArray<uint8>& Buffer, int64 LocalHeaderOffset)
+	{
+		if (LocalHeaderOffset < 0 || LocalHeaderOffset + LocalHeaderSize > Buffer.Num())
+		{
+			return INDEX_NONE;
+		}
+
+		const uint8* Header = Buffer.GetData() + LocalHeaderOffset;
+		if (ReadUInt32(Header) != LocalHeaderSignature)
+		{
+			return INDEX_NONE;
+		}
+
+		return LocalHeaderOffset + LocalHeaderSize + ReadUInt16(Header + 26) + ReadUInt16(Header + 28);
+	}
+}
+
+bool FHTTPZipExtractor::IsSafeRelativePath(const FString& RelativePath)
+{
+	if (RelativePath.IsEmpty() || RelativePath.StartsWith(TEXT("/")) || RelativePath.StartsWith(TEXT("\\")) || RelativePath.Contains(TEXT(":")))
+	{
+		return false;
+	}
+
+	TArray<FString> Parts;
+	RelativePath.ParseIntoArray(Parts, TEXT("/"), true);
+	for (const FString& Part : Parts)
+	{
+		if (Part == TEXT("..") || Part.Contains(TEXT("\\")))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FHTTPZipExtractor::MapEntryPath(const FString& EntryName, const FString& Prefix, bool bHasRootFolder, FString& OutRelativePath)
+{
+	OutRelativePath = EntryName;
+	if (bHasRootFolder && !EntryName.Split(TEXT("/"), nullptr, &OutRelativePath))
+	{
+		return false;
+	}
+
+	// A wildcard also matches the prefix deeper in the tree - only the top-level one counts
+	if (!OutRelativePath.StartsWith(Prefix, ESearchCase::CaseSensitive))
+	{
+		return false;
+	}
+	OutRelativePath.RightChopInline(Prefix.Len());
+
+	if (!IsSafeRelativePath(OutRelativePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FHTTPZipExtractor::Skipping unsafe entry %s."), *EntryName);
+		return false;
+	}
+
+	return true;
+}
+
+bool FHTTPZipExtractor::InflateEntry(uint16 CompressionMethod, const uint8* Data, int64 CompressedSize, int64 UncompressedSize, uint32 ExpectedCrc, TArray<uint8>& OutData)
+{
+	if (UncompressedSize < 0 || UncompressedSize > MAX_int32)
+	{
+		return false;
+	}
+
+	OutData.Reset(static_cast<int32>(UncompressedSize));
+
+	if (CompressionMethod == MZ_COMPRESS_METHOD_STORE)
+	{
+		if (CompressedSize != UncompressedSize)
+		{
+			return false;
+		}
+		OutData.Append(Data, static_cast<int32>(CompressedSize));
+	}
+	else if (CompressionMethod == MZ_COMPRESS_METHOD_DEFLATE)
+	{
+		FHTTPContentDecoder Decoder(true);
+		const bool bIsDecoded = Decoder.Decode(Data, CompressedSize, [&OutData, UncompressedSize](const uint8* Decoded, int64 DecodedNum)
+		{
+			if (OutData.Num() + DecodedNum > UncompressedSize)
+			{
+				return false;
+			}
+			OutData.Append(Decoded, static_cast<int32>(DecodedNum));
+			return true;
+		});
+
+		if (!bIsDecoded || !Decoder.IsFinished())
+		{
+			return false;
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPZipExtractor::Unsupported compression method %d."), CompressionMethod);
+		return false;
+	}
+
+	if (OutData.Num() != UncompressedSize)
+	{
+		return false;
+	}
+
+	return crc32(0, OutData.GetData(), OutData.Num()) == ExpectedCrc;
+}
+
+bool FHTTPZipExtractor::ExtractPrefix(const FHTTPZipMemoryStream& Archive, const FString& Prefix, const FString& DestinationDir, bool bHasRootFolder, TArray<FString>& OutFiles)
+{
+	if (!Archive.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPZipExtractor::Archive stream is invalid - returning."));
+		return false;
+	}
+
+	void* Reader = mz_zip_reader_create();
+	if (Reader == nullptr)
+	{
+		return false;
+	}
+
+	// The pattern is only referenced by the reader - it has to outlive the iteration
+	const FString Pattern = (bHasRootFolder ? TEXT("*/") : TEXT("")) + Prefix + TEXT("*");
+	FTCHARToUTF8 PatternUTF8(*Pattern);
+	mz_zip_reader_set_pattern(Reader, PatternUTF8.Get(), 0);
+
+	if (mz_zip_reader_open(Reader, Archive.GetStream()) != MZ_OK)
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPZipExtractor::Failed to open the archive."));
+		mz_zip_reader_delete(&Reader);
+		return false;
+	}
+
+	const TArray<uint8>& Buffer = Archive.GetBuffer();
+	bool bIsSucceeded = true;
+
+	for (int32 Result = mz_zip_reader_goto_first_entry(Reader); Result == MZ_OK; Result = mz_zip_reader_goto_next_entry(Reader))
+	{
+		if (mz_zip_reader_entry_is_dir(Reader) == MZ_OK)
+		{
+			continue;
+		}
+
+		mz_zip_file* FileInfo = nullptr;
+		if (mz_zip_reader_entry_get_info(Reader, &FileInfo) != MZ_OK || FileInfo == nullptr)
+		{
+			bIsSucceeded = false;
+			break;
+		}
+
+		const FString EntryName = UTF8_TO_TCHAR(FileInfo->filename);
+
+		FString RelativePath;
+		if (!MapEntryPath(EntryName, Prefix, bHasRootFolder, RelativePath))
+		{
+			continue;
+		}
+
+		if (FileInfo->flag & MZ_ZIP_FLAG_ENCRYPTED)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FHTTPZipExtractor::Skipping encrypted entry %s."), *EntryName);
+			continue;
+		}
+
+		const int64 DataOffset = HTTPZipExtractor::GetEntryDataOffset(Buffer, FileInfo->disk_offset);
+		if (DataOffset == INDEX_NONE || DataOffset + FileInfo->compressed_size > Buffer.Num())
+		{
+			UE_LOG(LogTemp, Error, TEXT("FHTTPZipExtractor::Entry %s points outside the archive."), *EntryName);
+			bIsSucceeded = false;
+			break;
+		}
+
+		TArray<uint8> Content;
+		if (!InflateEntry(FileInfo->compression_method, Buffer.GetData() + DataOffset, FileInfo->compressed_size, FileInfo->uncompressed_size, FileInfo->crc, Content))
+		{
+			UE_LOG(LogTemp, Error, TEXT("FHTTPZipExtractor::Failed to extract %s."), *EntryName);
+			bIsSucceeded = false;
+			break;
+		}
+
+		const FString FilePath = FPaths::ConvertRelativePathToFull(DestinationDir / RelativePath);
+		if (!FFileHelper::SaveArrayToFile(Content, *FilePath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("FHTTPZipExtractor::Failed to write %s."), *FilePath);
+			bIsSucceeded = false;
+			break;
+		}
+
+		OutFiles.Add(FilePath);
+	}
+
+	mz_zip_reader_close(Reader);
+	mz_zip_reader_delete(&Reader);
+
+	UE_LOG(LogTemp, Log, TEXT("FHTTPZipExtractor::Extracted %d files under %s into %s."), OutFiles.Num(), *Prefix, *DestinationDir);
+	return bIsSucceeded;
+}
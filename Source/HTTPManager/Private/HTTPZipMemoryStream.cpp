@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPZipMemoryStream.h"
+
+// ZIP
+#include "mz.h"
+#include "mz_strm.h"
+#include "mz_strm_mem.h"
+
+FHTTPZipMemoryStream::FHTTPZipMemoryStream(TArray<uint8>&& InBuffer)
+	: Buffer(MoveTemp(InBuffer))
+{
+	if (Buffer.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPZipMemoryStream::Buffer is empty - returning."));
+		return;
+	}
+
+	MemStream = mz_stream_mem_create();
+	if (MemStream == nullptr)
+	{
+		return;
+	}
+
+	// Read mode never frees or reallocates the buffer - it stays owned by this object
+	mz_stream_mem_set_buffer(MemStream, Buffer.GetData(), Buffer.Num());
+	if (mz_stream_mem_open(MemStream, nullptr, MZ_OPEN_MODE_READ) != MZ_OK)
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPZipMemoryStream::Failed to open the memory stream."));
+		mz_stream_mem_delete(&MemStream);
+	}
+}
+
+FHTTPZipMemoryStream::~FHTTPZipMemoryStream()
+{
+	if (MemStream != nullptr)
+	{
+		mz_stream_mem_close(MemStream);
+		mz_stream_mem_delete(&MemStream);
+	}
+}
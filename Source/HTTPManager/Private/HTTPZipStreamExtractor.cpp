@@ -0,0 +1,504 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HTTPZipStreamExtractor.h"
+#include "HTTPZipExtractor.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace HTTPZipStreamExtractor
+{
+	static const uint32 LocalHeaderSignature = 0x04034b50;
+	static const uint32 DescriptorSignature = 0x08074b50;
+	static const uint32 CentralHeaderSignature = 0x02014b50;
+	static const uint32 EndOfCentralDirSignature = 0x06054b50;
+
+	static const int32 SignatureSize = 4;
+	static const int32 LocalHeaderSize = 30;
+
+	static const uint16 Zip64ExtraTag = 0x0001;
+	static const uint16 FlagEncrypted = 1 << 0;
+	static const uint16 FlagDescriptor = 1 << 3;
+	static const uint16 MethodStore = 0;
+	static const uint16 MethodDeflate = 8;
+
+	static uint16 ReadUInt16(const uint8* Data)
+	{
+		return static_cast<uint16>(Data[0] | (Data[1] << 8));
+	}
+
+	static uint32 ReadUInt32(const uint8* Data)
+	{
+		return static_cast<uint32>(Data[0]) | (static_cast<uint32>(Data[1]) << 8) | (static_cast<uint32>(Data[2]) << 16) | (static_cast<uint32>(Data[3]) << 24);
+	}
+
+	static uint64 ReadUInt64(const uint8* Data)
+	{
+		return static_cast<uint64>(ReadUInt32(Data)) | (static_cast<uint64>(ReadUInt32(Data + 4)) << 32);
+	}
+}
+
+FHTTPZipStreamExtractor::FHTTPZipStreamExtractor()
+	: BytesReceived(0)
+{
+	SetIsSaving(true);
+	SetIsPersistent(false);
+}
+
+FHTTPZipStreamExtractor::~FHTTPZipStreamExtractor()
+{
+	FScopeLock ScopeLock(&Lock);
+	AbortEntry();
+	DiscardStagedFiles();
+}
+
+TSharedRef<FHTTPZipStreamExtractor> FHTTPZipStreamExtractor::Create(const FString& Prefix, const FString& DestinationDir, bool bHasRootFolder)
+{
+	TSharedRef<FHTTPZipStreamExtractor> Extractor = MakeShareable(new FHTTPZipStreamExtractor());
+	Extractor->Prefix = Prefix;
+	Extractor->DestinationDir = FPaths::ConvertRelativePathToFull(DestinationDir);
+	Extractor->bHasRootFolder = bHasRootFolder;
+	return Extractor;
+}
+
+void FHTTPZipStreamExtractor::Restart()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	AbortEntry();
+	DiscardStagedFiles();
+	ClearError();
+
+	State = EState::Signature;
+	HeaderBuffer.Reset();
+	BytesReceived = 0;
+}
+
+bool FHTTPZipStreamExtractor::Finish(TArray<FString>& OutFiles)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// Cut off in the middle of an entry - its ".part" file is of no use
+	AbortEntry();
+
+	OutFiles.Reset();
+	if (!IsError() && State != EState::Done)
+	{
+		UE_LOG(LogTemp, Error, TEXT("FHTTPZipStreamExtractor::Archive ended before its central directory."));
+		SetError();
+	}
+
+	// A partial archive updates nothing - the folder stays on the previous commit as a whole
+	if (IsError())
+	{
+		DiscardStagedFiles();
+		return false;
+	}
+
+	for (int32 Index = 0; Index < StagedFiles.Num(); ++Index)
+	{
+		const FString& TargetPath = StagedFiles[Index];
+		if (!IFileManager::Get().Move(*TargetPath, *(TargetPath + TEXT(".part")), true, true))
+		{
+			UE_LOG(LogTemp, Error, TEXT("FHTTPZipStreamExtractor::Failed to move %s into place - %d of %d files updated."), *TargetPath, Index, StagedFiles.Num());
+			StagedFiles.RemoveAt(0, Index);
+			DiscardStagedFiles();
+			SetError();
+			return false;
+		}
+
+		OutFiles.Add(TargetPath);
+	}
+
+	StagedFiles.Reset();
+	return true;
+}
+
+// Called on the HTTP thread for every received chunk
+void FHTTPZipStreamExtractor::Serialize(void* Data, int64 Num)
+{
+	if (Num <= 0)
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+
+	BytesReceived += Num;
+	if (!IsError())
+	{
+		Consume(static_cast<const uint8*>(Data), Num);
+	}
+}
+
+void FHTTPZipStreamExtractor::Consume(const uint8* Data, int64 Num)
+{
+	using namespace HTTPZipStreamExtractor;
+
+	while (!IsError() && State != EState::Done)
+	{
+		switch (State)
+		{
+			case EState::Signature:
+			{
+				if (!Gather(Data, Num, SignatureSize))
+				{
+					return;
+				}
+
+				const uint32 Signature = ReadUInt32(HeaderBuffer.GetData());
+				if (Signature == LocalHeaderSignature)
+				{
+					State = EState::LocalHeader;
+				}
+				// The entries are over - the central directory only repeats what we've already seen
+				else if (Signature == CentralHeaderSignature || Signature == EndOfCentralDirSignature)
+				{
+					State = EState::Done;
+				}
+				else
+				{
+					Fail(FString::Printf(TEXT("Unexpected signature 0x%08x"), Signature));
+				}
+				break;
+			}
+
+			case EState::LocalHeader:
+			{
+				if (!Gather(Data, Num, LocalHeaderSize) || !ParseLocalHeader())
+				{
+					return;
+				}
+				break;
+			}
+
+			case EState::EntryName:
+			{
+				if (!Gather(Data, Num, LocalHeaderSize + Entry.NameSize + Entry.ExtraSize) || !BeginEntry())
+				{
+					return;
+				}
+				break;
+			}
+
+			case EState::EntryData:
+			{
+				if (Num == 0)
+				{
+					return;
+				}
+
+				const int64 Consumed = ConsumeEntryData(Data, Num);
+				if (Consumed < 0)
+				{
+					return;
+				}
+				Data += Consumed;
+				Num -= Consumed;
+				break;
+			}
+
+			case EState::Descriptor:
+			{
+				if (!Gather(Data, Num, DescriptorSize) || !ParseDescriptor())
+				{
+					return;
+				}
+				break;
+			}
+
+			default:
+				return;
+		}
+	}
+}
+
+// Collects header bytes until HeaderBuffer holds Needed of them
+bool FHTTPZipStreamExtractor::Gather(const uint8*& Data, int64& Num, int32 Needed)
+{
+	const int64 Take = FMath::Min<int64>(Needed - HeaderBuffer.Num(), Num);
+	if (Take > 0)
+	{
+		HeaderBuffer.Append(Data, static_cast<int32>(Take));
+		Data += Take;
+		Num -= Take;
+	}
+
+	return HeaderBuffer.Num() >= Needed;
+}
+
+bool FHTTPZipStreamExtractor::ParseLocalHeader()
+{
+	using namespace HTTPZipStreamExtractor;
+
+	const uint8* Header = HeaderBuffer.GetData();
+
+	Entry = FEntry();
+	Entry.Flag = ReadUInt16(Header + 6);
+	Entry.Method = ReadUInt16(Header + 8);
+	Entry.Crc = ReadUInt32(Header + 14);
+	Entry.CompressedSize = ReadUInt32(Header + 18);
+	Entry.UncompressedSize = ReadUInt32(Header + 22);
+	Entry.NameSize = ReadUInt16(Header + 26);
+	Entry.ExtraSize = ReadUInt16(Header + 28);
+	Entry.bHasDescriptor = (Entry.Flag & FlagDescriptor) != 0;
+
+	State = EState::EntryName;
+	return true;
+}
+
+bool FHTTPZipStreamExtractor::BeginEntry()
+{
+	using namespace HTTPZipStreamExtractor;
+
+	const uint8* Name = HeaderBuffer.GetData() + LocalHeaderSize;
+	FUTF8ToTCHAR NameConverter(reinterpret_cast<const ANSICHAR*>(Name), Entry.NameSize);
+	Entry.Name = FString(NameConverter.Length(), NameConverter.Get());
+
+	// Zip64 extra field - the 64-bit sizes replace the saturated 32-bit ones, in this order
+	const uint8* Extra = Name + Entry.NameSize;
+	for (int32 Offset = 0; Offset + 4 <= Entry.ExtraSize; )
+	{
+		const uint16 Tag = ReadUInt16(Extra + Offset);
+		const uint16 Size = ReadUInt16(Extra + Offset + 2);
+		if (Offset + 4 + Size > Entry.ExtraSize)
+		{
+			break;
+		}
+
+		if (Tag == Zip64ExtraTag)
+		{
+			Entry.bIsZip64 = true;
+
+			int32 FieldOffset = Offset + 4;
+			if (Entry.UncompressedSize == MAX_uint32 && FieldOffset + 8 <= Offset + 4 + Size)
+			{
+				Entry.UncompressedSize = static_cast<int64>(ReadUInt64(Extra + FieldOffset));
+				FieldOffset += 8;
+			}
+			if (Entry.CompressedSize == MAX_uint32 && FieldOffset + 8 <= Offset + 4 + Size)
+			{
+				Entry.CompressedSize = static_cast<int64>(ReadUInt64(Extra + FieldOffset));
+			}
+		}
+
+		Offset += 4 + Size;
+	}
+
+	HeaderBuffer.Reset();
+
+	// Deflate marks its own end, stored data needs the size up front - a writer leaving it to the descriptor can't be streamed
+	const bool bIsEncrypted = (Entry.Flag & FlagEncrypted) != 0;
+	Entry.bIsSizeKnown = !Entry.bHasDescriptor || Entry.CompressedSize > 0 || Entry.Method == MethodStore;
+	if (!Entry.bIsSizeKnown && (Entry.Method != MethodDeflate || bIsEncrypted))
+	{
+		Fail(FString::Printf(TEXT("Entry %s has no size and can't be read forward-only"), *Entry.Name));
+		return false;
+	}
+
+	FString RelativePath;
+	const bool bIsDirectory = Entry.Name.EndsWith(TEXT("/"));
+	const bool bIsSupported = Entry.Method == MethodStore || Entry.Method == MethodDeflate;
+
+	if (!bIsDirectory && FHTTPZipExtractor::MapEntryPath(Entry.Name, Prefix, bHasRootFolder, RelativePath))
+	{
+		if (bIsEncrypted || !bIsSupported)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FHTTPZipStreamExtractor::Skipping encrypted or unsupported entry %s."), *Entry.Name);
+		}
+		else
+		{
+			Entry.TargetPath = DestinationDir / RelativePath;
+			IFileManager::Get().MakeDirectory(*FPaths::GetPath(Entry.TargetPath), true);
+
+			Entry.Writer.Reset(IFileManager::Get().CreateFileWriter(*(Entry.TargetPath + TEXT(".part"))));
+			if (!Entry.Writer.IsValid())
+			{
+				Fail(FString::Printf(TEXT("Failed to open %s.part for writing"), *Entry.TargetPath));
+				return false;
+			}
+		}
+	}
+
+	// Skipped deflated entries are still inflated when only the stream itself knows where it ends
+	if (Entry.Method == MethodDeflate && !bIsEncrypted && (Entry.Writer.IsValid() || !Entry.bIsSizeKnown))
+	{
+		Entry.Decoder = MakeUnique<FHTTPContentDecoder>(true);
+	}
+
+	State = EState::EntryData;
+
+	if (Entry.bIsSizeKnown && Entry.CompressedSize == 0)
+	{
+		EndEntryData();
+	}
+	return !IsError();
+}
+
+int64 FHTTPZipStreamExtractor::ConsumeEntryData(const uint8* Data, int64 Num)
+{
+	using namespace HTTPZipStreamExtractor;
+
+	const int64 Available = Entry.bIsSizeKnown ? FMath::Min(Num, Entry.CompressedSize - Entry.CompressedConsumed) : Num;
+	int64 Consumed = Available;
+
+	if (Entry.Decoder.IsValid())
+	{
+		const bool bIsDecoded = Entry.Decoder->Decode(Data, Available, [this](const uint8* Decoded, int64 DecodedNum)
+		{
+			return WriteEntryData(Decoded, DecodedNum);
+		}, &Consumed);
+
+		if (!bIsDecoded)
+		{
+			Fail(FString::Printf(TEXT("Entry %s is corrupted"), *Entry.Name));
+			return -1;
+		}
+
+		// The header's size wins over whatever padding follows the deflate stream
+		if (Entry.bIsSizeKnown)
+		{
+			Consumed = Available;
+		}
+	}
+	else if (Entry.Method == MethodStore && Entry.Writer.IsValid() && !WriteEntryData(Data, Available))
+	{
+		return -1;
+	}
+
+	Entry.CompressedConsumed += Consumed;
+
+	const bool bIsDataDone = Entry.bIsSizeKnown ? Entry.CompressedConsumed >= Entry.CompressedSize : Entry.Decoder->IsFinished();
+	if (bIsDataDone)
+	{
+		EndEntryData();
+	}
+	else if (Consumed < Available)
+	{
+		Fail(FString::Printf(TEXT("Deflate stream of %s stalled"), *Entry.Name));
+		return -1;
+	}
+
+	return Consumed;
+}
+
+bool FHTTPZipStreamExtractor::WriteEntryData(const uint8* Data, int64 Num)
+{
+	Entry.Written += Num;
+	if (!Entry.Writer.IsValid())
+	{
+		return true;
+	}
+
+	Entry.RunningCrc = crc32(Entry.RunningCrc, Data, static_cast<uInt>(Num));
+	Entry.Writer->Serialize(const_cast<uint8*>(Data), Num);
+	if (Entry.Writer->IsError())
+	{
+		Fail(FString::Printf(TEXT("Failed to write %s.part"), *Entry.TargetPath));
+		return false;
+	}
+
+	return true;
+}
+
+void FHTTPZipStreamExtractor::EndEntryData()
+{
+	HeaderBuffer.Reset();
+
+	if (Entry.bHasDescriptor)
+	{
+		// Signature (optional but written by everyone), CRC-32, compressed and uncompressed size
+		DescriptorSize = HTTPZipStreamExtractor::SignatureSize + 4 + (Entry.bIsZip64 ? 16 : 8);
+		State = EState::Descriptor;
+		return;
+	}
+
+	FinishEntry(Entry.Crc, Entry.UncompressedSize);
+	State = EState::Signature;
+}
+
+bool FHTTPZipStreamExtractor::ParseDescriptor()
+{
+	using namespace HTTPZipStreamExtractor;
+
+	const uint8* Descriptor = HeaderBuffer.GetData();
+	const int32 Offset = ReadUInt32(Descriptor) == DescriptorSignature ? SignatureSize : 0;
+
+	const uint32 Crc = ReadUInt32(Descriptor + Offset);
+	const int64 UncompressedSize = Entry.bIsZip64
+		? static_cast<int64>(ReadUInt64(Descriptor + Offset + 12))
+		: static_cast<int64>(ReadUInt32(Descriptor + Offset + 8));
+	const int32 DescriptorEnd = Offset + 4 + (Entry.bIsZip64 ? 16 : 8);
+
+	if (!FinishEntry(Crc, UncompressedSize))
+	{
+		return false;
+	}
+
+	// Without a signature the last bytes already belong to the next header
+	TArray<uint8> Leftover(HeaderBuffer.GetData() + DescriptorEnd, HeaderBuffer.Num() - DescriptorEnd);
+	HeaderBuffer = MoveTemp(Leftover);
+
+	State = EState::Signature;
+	return true;
+}
+
+bool FHTTPZipStreamExtractor::FinishEntry(uint32 ExpectedCrc, int64 ExpectedSize)
+{
+	if (!Entry.Writer.IsValid())
+	{
+		Entry = FEntry();
+		return true;
+	}
+
+	const FString PartPath = Entry.TargetPath + TEXT(".part");
+	const bool bIsClosed = Entry.Writer->Close();
+	Entry.Writer.Reset();
+
+	if (!bIsClosed || Entry.Written != ExpectedSize || Entry.RunningCrc != ExpectedCrc)
+	{
+		Fail(FString::Printf(TEXT("Entry %s failed verification"), *Entry.Name));
+		IFileManager::Get().Delete(*PartPath, false, true, true);
+		return false;
+	}
+
+	// Staged - moved into place by Finish once the rest of the archive arrived as well
+	StagedFiles.AddUnique(Entry.TargetPath);
+	Entry = FEntry();
+	return true;
+}
+
+void FHTTPZipStreamExtractor::AbortEntry()
+{
+	if (Entry.Writer.IsValid())
+	{
+		Entry.Writer->Close();
+		Entry.Writer.Reset();
+		IFileManager::Get().Delete(*(Entry.TargetPath + TEXT(".part")), false, true, true);
+	}
+
+	Entry = FEntry();
+}
+
+void FHTTPZipStreamExtractor::DiscardStagedFiles()
+{
+	for (const FString& TargetPath : StagedFiles)
+	{
+		IFileManager::Get().Delete(*(TargetPath + TEXT(".part")), false, true, true);
+	}
+
+	StagedFiles.Reset();
+}
+
+void FHTTPZipStreamExtractor::Fail(const FString& Reason)
+{
+	UE_LOG(LogTemp, Error, TEXT("FHTTPZipStreamExtractor::%s."), *Reason);
+
+	AbortEntry();
+	SetError();
+}
@@ -2,6 +2,17 @@
 
 
 #include "MacrosManager.h"
+#include "HTTPContentDecoder.h"
+#include "HTTPMetrics.h"
+#include "HTTPRateLimiter.h"
+#include "HTTPRequestQueue.h"
+#include "HTTPRequester.h"
+#include "HTTPResponseCache.h"
+#include "HTTPResponseStream.h"
+#include "HTTPStreamHasher.h"
+#include "HTTPZipExtractor.h"
+#include "HTTPZipMemoryStream.h"
+#include "HTTPZipStreamExtractor.h"
 // Components
 #include "Components/Image.h"
 #include "Components/Button.h"
@@ -13,7 +24,14 @@
 #include "Components/MultiLineEditableTextBox.h"
 
 // Utilities
+#include "Async/Async.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "HAL/FileManager.h"
 #include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "PlatformHttp.h"
+#include "Tasks/Pipe.h"
+#include "Tasks/Task.h"
 // Externals
 extern UMaterialInstanceDynamic* ThrowDynamicInstance(float ScalarValue);
 extern void ThrowDialogMessage(FString Message);
@@ -25,6 +43,21 @@ extern void SaveJsonArrayToFile_UTIL(const FString& JSONSubPath, const TArray<TS
 
 extern void RSSManifestInit_UTIL();
 
+// Local blob SHAs of the last delta sync - see ScanLocalBlobs_UTIL
+static FString GetBlobIndexPath_UTIL()
+{
+    return FPaths::ProjectSavedDir() / TEXT("MacrosManager") / TEXT("BlobIndex.json");
+}
+
+// RSSInit field holding the commit the local folder was last synced to
+static const TCHAR* SyncedCommitShaField = TEXT("SyncedCommitSha");
+
+// Rate limit counts are written back to RSSInit at most once per this many seconds - every response reports one
+static const float RateLimitSaveDelay = 5.0f;
+
+// Every RSSInit update of the widget runs on this pipe - off the game thread and never two read-modify-writes at once
+static UE::Tasks::FPipe RSSInitPipe(TEXT("RSSInitPipe"));
+
 
 void UMacrosManager::NativePreConstruct()
 {
@@ -43,6 +76,8 @@ void UMacrosManager::NativeConstruct()
 
     this->HandleThisLifycycle();
 
+    RateLimitUpdatedHandle = FHTTPRateLimiter::Get().OnRateLimitUpdated.AddUObject(this, &UMacrosManager::OnRateLimitUpdated);
+
     // SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(1));
     // ThrowDialogMessage("Remember to sync changes before continue any further.");
 }
@@ -51,6 +86,28 @@ void UMacrosManager::NativeDestruct()
 {
     Super::NativeDestruct();
 
+    FHTTPRateLimiter::Get().OnRateLimitUpdated.Remove(RateLimitUpdatedHandle);
+
+    // The budget is seeded from RSSInit on the next construct - don't lose the last count
+    if (RateLimitSaveTickerHandle.IsValid())
+    {
+        SaveRateLimit_UTIL();
+    }
+
+    // Nobody consumes the responses of a closed widget - free the slots and the bandwidth
+    if (RequestsToken.IsValid())
+    {
+        RequestsToken->Cancel();
+        RequestsToken.Reset();
+    }
+    SyncCancellationToken.Reset();
+
+    if (SyncProgressTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(SyncProgressTickerHandle);
+        SyncProgressTickerHandle.Reset();
+    }
+
     // ThrowDialogMessage("Remember to sync changes before continue any further.");
 }
 
@@ -65,73 +122,184 @@ void UMacrosManager::RequestDestroyWindow()
     UE_LOG(LogTemp, Error, TEXT("Destruct fired"));
 }
 
+// The function restores the widget from RSSInit - read on the RSSInit pipe, so updates still in flight land first;
 void UMacrosManager::HandleThisLifycycle()
 {
-    FString RSSInitSubPath = TEXT("\\RSS\\RSSInit.json");
-    FString RSSInitModule = TEXT("LifecycleInit");
-    FString RSSInitField = TEXT("MacrosManager");
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    ReadRSSInit_UTIL("HandleThisLifycycle", [WeakThis](TSharedPtr<FJsonObject> RSSMacrosManager)
+    {
+        UMacrosManager* MacrosManager = WeakThis.Get();
+        if (MacrosManager == nullptr || RSSMacrosManager == nullptr)
+        {
+            return;
+        }
+
+        // The budget left by the previous session - requests wait for the reset instead of failing against an exhausted limit
+        MacrosManager->RateLimitHost = FPlatformHttp::GetUrlDomain(RSSMacrosManager->GetStringField(TEXT("Repository")));
+        FString RateLimit = RSSMacrosManager->GetStringField(TEXT("RateLimit"));
+        FString RateLimitResetAt = RSSMacrosManager->GetStringField(TEXT("RateLimitResetAt"));
+        if (RateLimit.IsNumeric() && RateLimitResetAt.IsNumeric())
+        {
+            // Already in RSSInit - seeding the limiter shouldn't write it back
+            MacrosManager->SavedRateLimit = FCString::Atoi(*RateLimit);
+            MacrosManager->SavedRateLimitResetAt = FCString::Atoi64(*RateLimitResetAt);
+            FHTTPRateLimiter::Get().Update(MacrosManager->RateLimitHost, 0, MacrosManager->SavedRateLimit, MacrosManager->SavedRateLimitResetAt);
+        }
+
+        if (RSSMacrosManager->GetBoolField(TEXT("bIsInitialized")))
+        {
+            MacrosManager->SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(RSSMacrosManager->GetNumberField(TEXT("SyncState"))));
+            return;
+        }
+
+        MacrosManager->MacrosManager_EXP->SetIsEnabled(false);
+        MacrosManager->MacrosManager_EXP->SetIsExpanded(false);
+    });
+}
+
+void UMacrosManager::RSSManifestInit()
+{
+    RSSManifestInit_UTIL();
+}
 
-    TArray<TSharedPtr<FJsonValue>> JsonArray = ThrowJsonArrayFromFile_UTIL(RSSInitSubPath);
-    if (JsonArray.IsEmpty())
+// The function keeps RSSInit in line with the shared rate limiter - every request in the process spends the same budget;
+// --> The latest count is written back once per RateLimitSaveDelay, not once per response;
+void UMacrosManager::OnRateLimitUpdated(const FString& Host, int32 Remaining, int64 ResetAt)
+{
+    if (Host != RateLimitHost)
     {
-        UE_LOG(LogTemp, Error, TEXT("HandleThisLifycycle::JsonArray is empty - returning."));
         return;
     }
-    
-    TSharedPtr<FJsonObject> RSSMacrosManager = ThrowRSSInitModule_UTIL(JsonArray, RSSInitModule, RSSInitField);
-    if (RSSMacrosManager == nullptr)
+
+    PendingRateLimit = Remaining;
+    PendingRateLimitResetAt = ResetAt;
+
+    if (RateLimitSaveTickerHandle.IsValid() || (Remaining == SavedRateLimit && ResetAt == SavedRateLimitResetAt))
     {
-        UE_LOG(LogTemp, Error, TEXT("HandleThisLifycycle::MacrosManager is nullptr - returning."));
         return;
     }
 
-    if (RSSMacrosManager->GetBoolField(TEXT("bIsInitialized")))
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    RateLimitSaveTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis](float DeltaTime)
+    {
+        if (UMacrosManager* MacrosManager = WeakThis.Get())
+        {
+            MacrosManager->SaveRateLimit_UTIL();
+        }
+        return false;
+    }), RateLimitSaveDelay);
+}
+
+// The function writes the pending rate limit to RSSInit - skipped if it's already there;
+void UMacrosManager::SaveRateLimit_UTIL()
+{
+    if (RateLimitSaveTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(RateLimitSaveTickerHandle);
+        RateLimitSaveTickerHandle.Reset();
+    }
+
+    if (PendingRateLimit == SavedRateLimit && PendingRateLimitResetAt == SavedRateLimitResetAt)
     {
-        SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(RSSMacrosManager->GetNumberField(TEXT("SyncState"))));
         return;
     }
 
-    MacrosManager_EXP->SetIsEnabled(false);
-    MacrosManager_EXP->SetIsExpanded(false);
+    SavedRateLimit = PendingRateLimit;
+    SavedRateLimitResetAt = PendingRateLimitResetAt;
+
+    UpdateRSSInit_UTIL("OnRateLimitUpdated", [Remaining = SavedRateLimit, ResetAt = SavedRateLimitResetAt](FJsonObject& RSSMacrosManager)
+    {
+        RSSMacrosManager.SetStringField(TEXT("RateLimit"), FString::FromInt(Remaining));
+        RSSMacrosManager.SetStringField(TEXT("RateLimitResetAt"), LexToString(ResetAt));
+    });
 }
 
-void UMacrosManager::RSSManifestInit()
+// The function applies Update to the MacrosManager module of RSSInit on the RSSInit pipe - the file is never touched on the game thread;
+void UMacrosManager::UpdateRSSInit_UTIL(FString FunctionName, TFunction<void(FJsonObject&)> Update)
 {
-    RSSManifestInit_UTIL();
+    RSSInitPipe.Launch(UE_SOURCE_LOCATION, [FunctionName, Update]()
+    {
+        FString RSSInitSubPath = TEXT("\\RSS\\RSSInit.json");
+        FString RSSInitModule = TEXT("LifecycleInit");
+        FString RSSInitField = TEXT("MacrosManager");
+
+        TArray<TSharedPtr<FJsonValue>> JsonArray = ThrowJsonArrayFromFile_UTIL(RSSInitSubPath);
+        if (JsonArray.IsEmpty())
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s::JsonArray is empty - returning."), *FunctionName);
+            return;
+        }
+
+        TSharedPtr<FJsonObject> RSSMacrosManager = ThrowRSSInitModule_UTIL(JsonArray, RSSInitModule, RSSInitField);
+        if (RSSMacrosManager == nullptr)
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s::MacrosManager is nullptr - returning."), *FunctionName);
+            return;
+        }
+
+        Update(*RSSMacrosManager);
+
+        SaveJsonArrayToFile_UTIL(RSSInitSubPath, JsonArray);
+    });
+}
+
+// The function reads the MacrosManager module of RSSInit on the RSSInit pipe - OnRead runs on the game thread, with nullptr if it's missing;
+void UMacrosManager::ReadRSSInit_UTIL(FString FunctionName, TFunction<void(TSharedPtr<FJsonObject> RSSMacrosManager)> OnRead)
+{
+    RSSInitPipe.Launch(UE_SOURCE_LOCATION, [FunctionName, OnRead]()
+    {
+        FString RSSInitSubPath = TEXT("\\RSS\\RSSInit.json");
+        FString RSSInitModule = TEXT("LifecycleInit");
+        FString RSSInitField = TEXT("MacrosManager");
+
+        TSharedPtr<FJsonObject> RSSMacrosManager;
+        TArray<TSharedPtr<FJsonValue>> JsonArray = ThrowJsonArrayFromFile_UTIL(RSSInitSubPath);
+        if (JsonArray.IsEmpty())
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s::JsonArray is empty."), *FunctionName);
+        }
+        else
+        {
+            RSSMacrosManager = ThrowRSSInitModule_UTIL(JsonArray, RSSInitModule, RSSInitField);
+            if (RSSMacrosManager == nullptr)
+            {
+                UE_LOG(LogTemp, Error, TEXT("%s::MacrosManager is nullptr."), *FunctionName);
+            }
+        }
+
+        // The parsed object is owned by this read only - safe to hand over to the game thread
+        AsyncTask(ENamedThreads::GameThread, [OnRead, RSSMacrosManager]()
+        {
+            OnRead(RSSMacrosManager);
+        });
+    });
 }
 
 // The function is designed to initialize the Macros Manager as an editor window; 
 // The main responsibility is tracking post-sync progress by making a timestamp - it should prevent loosing data after widgets recompilation; 
+// --> The read-modify-write runs on the RSSInit pipe - only the widget is updated on the game thread;
 void UMacrosManager::RSSInit()
 {
-    FString RSSInitSubPath = TEXT("\\RSS\\RSSInit.json");
-    FString RSSInitModule = TEXT("LifecycleInit");
-    FString RSSInitField = TEXT("MacrosManager");
-
-    TArray<TSharedPtr<FJsonValue>> JsonArray = ThrowJsonArrayFromFile_UTIL(RSSInitSubPath);
-    if (JsonArray.IsEmpty())
-    {
-        UE_LOG(LogTemp, Error, TEXT("RSSInit::JsonArray is empty - returning."));
-        return;
-    }
-    
-    TSharedPtr<FJsonObject> RSSMacrosManager = ThrowRSSInitModule_UTIL(JsonArray, RSSInitModule, RSSInitField);
-    if (RSSMacrosManager == nullptr)
-    {
-        UE_LOG(LogTemp, Error, TEXT("RSSInit::MacrosManager is nullptr - returning."));
-        return;
-    }
-
-    if (RSSMacrosManager->GetBoolField(TEXT("bIsInitialized")))
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    UpdateRSSInit_UTIL("RSSInit", [WeakThis](FJsonObject& RSSMacrosManager)
     {
-        return;
-    }
+        if (RSSMacrosManager.GetBoolField(TEXT("bIsInitialized")))
+        {
+            return;
+        }
 
-    SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(RSSMacrosManager->GetNumberField(TEXT("SyncState"))));
-    RSSMacrosManager->SetBoolField(TEXT("bIsInitialized"), true);
-    MacrosManager_EXP->SetIsEnabled(true);
+        RSSMacrosManager.SetBoolField(TEXT("bIsInitialized"), true);
 
-    SaveJsonArrayToFile_UTIL(RSSInitSubPath, JsonArray);
+        float SyncState = RSSMacrosManager.GetNumberField(TEXT("SyncState"));
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, SyncState]()
+        {
+            if (UMacrosManager* MacrosManager = WeakThis.Get())
+            {
+                MacrosManager->SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(SyncState));
+                MacrosManager->MacrosManager_EXP->SetIsEnabled(true);
+            }
+        });
+    });
 
     // UE_LOG(LogTemp, Warning, TEXT("RSSInit::Initialization successful - %f."), RSSMacrosManager->GetNumberField(TEXT("SyncState")));
 
@@ -313,306 +481,1550 @@ void UMacrosManager::ScrollBackward(FString &OutContent)
     }
 }
 
-// The function is under development - potentially deprecated;
-// Imitates recursion by checking subdirectories for last changes on the repository; 
+// The function crawls the contents API breadth-first with bounded concurrency - FetchTree_SYNC lists the same files in one request;
+// The crawl state is shared by every directory request, OnCrawlFinished fires once with the aggregated file list;
 void UMacrosManager::FetchFilesRecursive_SYNC(FString FullURLPath)
 {
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(FullURLPath);
-    Request->SetVerb("GET");
-    Request->OnProcessRequestComplete().BindLambda([this, FullURLPath](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+    TSharedRef<FMacrosCrawlState> State = MakeShared<FMacrosCrawlState>();
+    State->PendingURLs.Add(FullURLPath);
+    State->VisitedURLs.Add(FullURLPath);
 
-    {
-        int32 ResponseCode = Response->GetResponseCode();
-        if (bWasSuccessful && ResponseCode == 200)
-        {
-            TArray<TSharedPtr<FJsonValue>> JsonArray;
-            TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-
-            if (FJsonSerializer::Deserialize(Reader, JsonArray))
-            {
-                TArray<FString> FileList;
-                for (TSharedPtr<FJsonValue> Value : JsonArray)
-                {
-                    if (Value.IsValid() && Value->Type == EJson::Object)
-                    {
-                        TSharedPtr<FJsonObject> Object = Value->AsObject();
-                        FString Name = Object->GetStringField(TEXT("name"));
-                        FString Type = Object->GetStringField(TEXT("type"));
-                        FString Path = Object->GetStringField(TEXT("path"));
-
-                        if (Type == "file")
-                        {
-                            FileList.Add(Path);
-                            UE_LOG(LogTemp, Log, TEXT("File found: %s"), *Path);
-                        }
-                        else if (Type == "dir") // It's a subfolder, fetch its contents
-                        {
-                            FString SubFullURLPath = FullURLPath / Path + TEXT("/");
-                            FetchFilesRecursive_SYNC(SubFullURLPath); // Recursively fetch files
-                        }
-                    }
-                }
-            }
-        }
-        else
-        {
-            FString RateLimit = Response->GetHeader("X-RateLimit-Remaining");
-            FString RateReset = Response->GetHeader("X-RateLimit-Reset");
-            
-            UE_LOG(LogTemp, Error, TEXT("Failed to fetch: %s"), *FullURLPath);
-            UE_LOG(LogTemp, Error, TEXT("Unexpected response: %d"), ResponseCode);
-            UE_LOG(LogTemp, Warning, TEXT("Rate limit remaining: %s, resets at: %s"), *RateLimit, *RateReset);
-        }
-    });
-
-    Request->ProcessRequest();
+    // Every directory request of the crawl shares one token - cancelling the sync or hitting SyncTimeout stops the whole tree
+    PumpCrawl_UTIL(State, StartSync_UTIL());
 }
 
-// void UMacrosManager::SearchInRepository(const FString &RepoOwner, const FString &RepoName, const FString &FolderPath)
-// {
-// 	// Build the API request URL
-// 	FString URL = FString::Printf(TEXT("https://api.github.com/repos/%s/%s/contents/Macros/%s"), 
-// 		*RepoOwner, *RepoName, *FolderPath);
-	
-// 	// Create the HTTP request
-// 	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-// 	Request->OnProcessRequestComplete().BindUObject(this, &UMacrosManager::OnSearchInRepositoryResponse);
-// 	Request->SetURL(URL);
-// 	Request->SetVerb(TEXT("GET"));
-// 	Request->ProcessRequest();
-// }
-
-// void UMacrosManager::OnSearchInRepositoryResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
-// {
-// 	if (!bWasSuccessful || !Response.IsValid())
-// 	{
-// 		UE_LOG(LogTemp, Error, TEXT("Request failed or invalid response."));
-//         CustomLog_FText_UTIL("OnSearchInRepositoryResponse", "Request failed or invalid response - returning");
-// 		return;
-// 	}
-
-//     int32 ResponseCode = Response->GetResponseCode();
-//     if (ResponseCode == 200) // Folder exists
-//     {
-//         TArray<TSharedPtr<FJsonValue>> JsonArray;
-//         TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-        
-//         if (FJsonSerializer::Deserialize(Reader, JsonArray))
-//         {
-//             UE_LOG(LogTemp, Log, TEXT("JSON Response contains %d items:"), JsonArray.Num());
-
-//             for (TSharedPtr<FJsonValue> Value : JsonArray)
-//             {
-//                 if (Value.IsValid() && Value->Type == EJson::Object)
-//                 {
-//                     TSharedPtr<FJsonObject> Object = Value->AsObject();
-//                     FString Name = Object->GetStringField(TEXT("name"));
-//                     FString Type = Object->GetStringField(TEXT("type"));
-        
-//                     UE_LOG(LogTemp, Log, TEXT("Name: %s, Type: %s"), *Name, *Type);
-//                 }
-//             }
-//         }
-//     }
-//     else if (ResponseCode == 404)
-//     {
-//         UE_LOG(LogTemp, Warning, TEXT("❌ Folder does NOT exist."));
-//         CustomLog_FText_UTIL("OnSearchInRepositoryResponse", "Folder does NOT exist.");
-//     }
-//     else
-//     {
-//         UE_LOG(LogTemp, Error, TEXT("Unexpected response: %d"), ResponseCode);
-//         CustomLog_FText_UTIL("OnSearchInRepositoryResponse", (TEXT("Unexpected response: ") + ResponseCode));
-//     }
+// The function sends queued directories while crawl slots are free and reports the crawl once nothing is left in flight;
+void UMacrosManager::PumpCrawl_UTIL(TSharedRef<FMacrosCrawlState> State, TSharedRef<FHTTPCancellationToken> CrawlToken)
+{
+    if (CrawlToken->IsCancelled())
+    {
+        State->PendingURLs.Reset();
+    }
 
-// 	// Check HTTP response code
-// 	int32 ResponseCode = Response->GetResponseCode();
-// 	if (ResponseCode == 200)
-// 	{
-// 		UE_LOG(LogTemp, Log, TEXT("✅ Folder exists!"));
-// 	}
-// 	else if (ResponseCode == 404)
-// 	{
-// 		UE_LOG(LogTemp, Warning, TEXT("❌ Folder does NOT exist."));
-// 	}
-// 	else
-// 	{
-// 		UE_LOG(LogTemp, Error, TEXT("Unexpected response: %d"), ResponseCode);
-// 	}
-// }
+    while (State->InFlight < FMath::Max(MaxCrawlConcurrency, 1) && !State->PendingURLs.IsEmpty())
+    {
+        const FString NextURLPath = State->PendingURLs[0];
+        State->PendingURLs.RemoveAt(0);
+        State->InFlight++;
+        FetchFilesRecursive_UTIL(NextURLPath, State, CrawlToken);
+    }
 
-// Reflects content to a text - bound to work in the editor utility widget blueprint;
-FString UMacrosManager::ReflectFileToScreen_UTIL(int32 CurrentIndex)
-{
-    FString Content;
-    FFileHelper::LoadFileToString(Content, *MacrossArray_FullPath[CurrentIndex]);
+    if (State->InFlight > 0 || State->bIsFinished)
+    {
+        return;
+    }
+    State->bIsFinished = true;
 
-    return Content;
-}
+    const bool bIsSucceeded = State->NumFailed == 0 && !CrawlToken->IsCancelled();
+    State->FileList.Sort();
+    CrawledFiles = MoveTemp(State->FileList);
 
-// The function build custom log message - bound to work in the editor utility widget blueprint;
-void UMacrosManager::CustomLog_FText_UTIL(FString FunctionName, FString LogText)
-{
-    FString logBuild = CustomLogPrefix + FunctionName + TEXT("::") + LogText + TEXT(".");
-    CustomLog_TXT->SetText(FText::FromString(logBuild));
+    CustomLog_FText_UTIL("FetchFilesRecursive", FString::Printf(TEXT("%d files found in %d directories%s"),
+        CrawledFiles.Num(), State->VisitedURLs.Num(), bIsSucceeded ? TEXT("") : TEXT(" - the list is incomplete")));
+    OnCrawlFinished.Broadcast(bIsSucceeded, CrawledFiles);
 }
 
-// The function checks when the last local changes were made;
-FDateTime UMacrosManager::CheckLocalChanges(FString LocalFolderPath)
+// The function fetches one directory of the crawl - its files join the aggregated list, its subdirectories the work list;
+void UMacrosManager::FetchFilesRecursive_UTIL(FString FullURLPath, TSharedRef<FMacrosCrawlState> State, TSharedRef<FHTTPCancellationToken> CrawlToken)
 {
-    FDateTime LastModifiedUTC = IFileManager::Get().GetTimeStamp(*LocalFolderPath);
-    
-    // Convert to local time
-    FDateTime LastModifiedLocal = LastModifiedUTC + (FDateTime::Now() - FDateTime::UtcNow());
+    // Background - the crawl must not hold up the widget's own calls
+    FHTTPRequestOptions Options;
+    Options.Priority = EHTTPRequestPriority::Background;
+    Options.CancellationToken = CrawlToken;
 
-    // FString LastModifiedStr = LastModifiedLocal.ToString();
-    // UE_LOG(LogTemp, Warning, TEXT("Last modified (Local Time): %s"), *LastModifiedStr);
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
 
-    return LastModifiedLocal;
-}
+    // Returns the crawl slot of this directory - every completion, cancelled ones included, ends up here exactly once
+    auto OnListed = [WeakThis, State, CrawlToken](bool bIsListed, TArray<FString> Files, TArray<FString> SubFullURLPaths)
+    {
+        UMacrosManager* MacrosManager = WeakThis.Get();
+        if (MacrosManager == nullptr)
+        {
+            return;
+        }
 
-// The function checks when the last changes were made in files on GitHub;
-void UMacrosManager::GetLastModifiedFromGitHub(FString RepositoryURL, FString LocalFolderPath, bool &bIsSyncNeeded)
-{
-    FString Url = RepositoryURL;
-   
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(Url);
-    Request->SetVerb("GET");
+        State->InFlight--;
+        State->FileList.Append(MoveTemp(Files));
+        if (!bIsListed)
+        {
+            State->NumFailed++;
+        }
 
-    Request->OnProcessRequestComplete().BindLambda(
-        [this, LocalFolderPath, &bIsSyncNeeded](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSuccess)
+        for (const FString& SubFullURLPath : SubFullURLPaths)
         {
-            if (bSuccess && Response.IsValid())
+            bool bIsVisited = false;
+            State->VisitedURLs.Add(SubFullURLPath, &bIsVisited);
+            if (!bIsVisited)
             {
-                UE_LOG(LogTemp, Warning, TEXT("HTTP Response Code: %d"), Response->GetResponseCode());
+                State->PendingURLs.Add(SubFullURLPath);
+            }
+        }
 
-                FString RateLimit = Response->GetHeader("X-RateLimit-Remaining");
-                FString RateReset = Response->GetHeader("X-RateLimit-Reset");
-                UE_LOG(LogTemp, Warning, TEXT("Rate limit remaining: %s, resets at: %s"), *RateLimit, *RateReset);
+        MacrosManager->PumpCrawl_UTIL(State, CrawlToken);
+    };
 
-                FString ResponseStr = Response->GetContentAsString();
-                // UE_LOG(LogTemp, Warning, TEXT("GitHub API Response: %s"), *ResponseStr);
-                
-                TArray<TSharedPtr<FJsonValue>> CommitArray;
-                TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());                
+    // Queued - transient failures and rate limits are retried by the shared policy before landing in the error branch
+    FHTTPRequestQueue::Get().EnqueueCoalesced(FullURLPath,
+        [FullURLPath](const FHttpRequestRef& Request)
+        {
+            FHTTPResponseCache::Get().ApplyValidators(FullURLPath, Request);
+            FHTTPContentDecoder::ApplyAcceptEncoding(FullURLPath, Request);
+            return true;
+        },
+        [WeakThis, FullURLPath, CrawlToken, OnListed](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+        {
+            if (!WeakThis.IsValid() || CrawlToken->IsCancelled())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Sync cancelled - dropping: %s"), *FullURLPath);
+                OnListed(false, TArray<FString>(), TArray<FString>());
+                return;
+            }
+
+            // Decoding and parsing the listing run on a worker - only the follow-up requests are queued from the game thread
+            UE::Tasks::Launch(UE_SOURCE_LOCATION, [FullURLPath, OnListed, Response, bWasSuccessful]()
+            {
+                const double WorkerStartTime = FPlatformTime::Seconds();
+                int32 ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
 
-                if (FJsonSerializer::Deserialize(Reader, CommitArray) && CommitArray.Num() > 0)
+                // 200 or 304 answered from the cache
+                bool bIsListed = false;
+                FString ResponseStr;
+                TArray<FString> FileList;
+                TArray<FString> SubFullURLPaths;
+                if (bWasSuccessful && FHTTPResponseCache::Get().ResolveBodyAsString(FullURLPath, Response, ResponseStr))
                 {
-                    UE_LOG(LogTemp, Warning, TEXT("The JsonObject was successfully serialazide."));
+                    TArray<TSharedPtr<FJsonValue>> JsonArray;
+                    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseStr);
 
-                    // Navigate the JSON structure to find the commit date
-                    TSharedPtr<FJsonObject> CommitObject = CommitArray[0]->AsObject();
-                    if (CommitObject.IsValid())
+                    bIsListed = FJsonSerializer::Deserialize(Reader, JsonArray);
+                    for (TSharedPtr<FJsonValue> Value : JsonArray)
                     {
-                        FString DateString = CommitObject->GetObjectField(TEXT("commit"))
-                                                         ->GetObjectField(TEXT("author"))
-                                                         ->GetStringField(TEXT("date"));
-
-                        FDateTime ParsedTime;
-                        FDateTime::ParseIso8601(*DateString, ParsedTime);
-                        FDateTime LocalTimeStamp = this->CheckLocalChanges(LocalFolderPath);
-                        FDateTime GitHubTimeStamp = ParsedTime + (FDateTime::Now() - FDateTime::UtcNow());
-
-                        FTimespan Difference = GitHubTimeStamp - LocalTimeStamp;
-
-                        if (GitHubTimeStamp > LocalTimeStamp && FMath::Abs(Difference.GetTotalMinutes()) > 2.0)
+                        if (Value.IsValid() && Value->Type == EJson::Object)
                         {
-                            bIsSyncNeeded = true;
-                            FString logBuild = FString::Printf(TEXT("Last Local Changes: %s\nLast GitHub Commit: %s"), *LocalTimeStamp.ToString(), *GitHubTimeStamp.ToString());
-                            CustomLog_TXT->SetText(FText::FromString(logBuild));
-
-                            SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(2));
+                            TSharedPtr<FJsonObject> Object = Value->AsObject();
+                            FString Type = Object->GetStringField(TEXT("type"));
+                            FString Path = Object->GetStringField(TEXT("path"));
 
-                            FString RSSInitSubPath = TEXT("\\RSS\\RSSInit.json");
-                            FString RSSInitModule = TEXT("LifecycleInit");
-                            FString RSSInitField = TEXT("MacrosManager");
-
-                            TArray<TSharedPtr<FJsonValue>> JsonArray = ThrowJsonArrayFromFile_UTIL(RSSInitSubPath);
-                            if (JsonArray.IsEmpty())
+                            if (Type == "file")
                             {
-                                UE_LOG(LogTemp, Error, TEXT("RSSInit::JsonArray is empty - returning."));
-                                return;
+                                FileList.Add(Path);
+                                UE_LOG(LogTemp, Log, TEXT("File found: %s"), *Path);
                             }
-                            
-                            TSharedPtr<FJsonObject> RSSMacrosManager = ThrowRSSInitModule_UTIL(JsonArray, RSSInitModule, RSSInitField);
-                            if (RSSMacrosManager == nullptr)
+                            else if (Type == "dir") // It's a subfolder, queue its contents
                             {
-                                UE_LOG(LogTemp, Error, TEXT("RSSInit::MacrosManager is nullptr - returning."));
-                                return;
+                                // "url" is the contents URL of the subfolder itself, ref included - "path" is relative to the repository root
+                                FString SubFullURLPath;
+                                if (!Object->TryGetStringField(TEXT("url"), SubFullURLPath))
+                                {
+                                    SubFullURLPath = FullURLPath / Object->GetStringField(TEXT("name")) + TEXT("/");
+                                }
+                                SubFullURLPaths.Add(SubFullURLPath);
                             }
+                        }
+                    }
+                }
+                else
+                {
+                    FString RateLimit = Response.IsValid() ? Response->GetHeader("X-RateLimit-Remaining") : FString();
+                    FString RateReset = Response.IsValid() ? Response->GetHeader("X-RateLimit-Reset") : FString();
+                
+                    UE_LOG(LogTemp, Error, TEXT("Failed to fetch: %s"), *FullURLPath);
+                    UE_LOG(LogTemp, Error, TEXT("Unexpected response: %d"), ResponseCode);
+                    UE_LOG(LogTemp, Warning, TEXT("Rate limit remaining: %s, resets at: %s"), *RateLimit, *RateReset);
+                }
 
-                            RSSMacrosManager->SetNumberField(TEXT("SyncState"), 2);
-                            RSSMacrosManager->SetStringField(TEXT("RateLimit"), *RateLimit);
-                            RSSMacrosManager->SetStringField(TEXT("RateLimitResetAt"), *RateReset);
-                            RSSMacrosManager->SetNumberField(TEXT("ResponseCode"), 200);
+                FHTTPMetrics::Get().RecordWorker(FullURLPath, FPlatformTime::Seconds() - WorkerStartTime);
 
-                            SaveJsonArrayToFile_UTIL(RSSInitSubPath, JsonArray);
-                            
-                            UE_LOG(LogTemp, Warning, TEXT("Last Local Changes: %s"), *LocalTimeStamp.ToString());
-                            UE_LOG(LogTemp, Warning, TEXT("Last GitHub Commit: %s"), *GitHubTimeStamp.ToString());
-                        }
-                        else
-                        {
-                            SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(0));
+                AsyncTask(ENamedThreads::GameThread, [OnListed, bIsListed, FileList = MoveTemp(FileList), SubFullURLPaths = MoveTemp(SubFullURLPaths)]() mutable
+                {
+                    OnListed(bIsListed, MoveTemp(FileList), MoveTemp(SubFullURLPaths));
+                });
+            });
+        },
+        Options);
+}
 
-                            // Re-wrap into another function in order to change a single specific parameter
-                            // Alternatively - set up RSSInit as completed only aftere sync
-                            // this->RSSInit();
+// The function lists the remote tree in one request - the contents crawl needs one per directory;
+void UMacrosManager::FetchTree_SYNC(FString TreeURL, FString PathPrefix)
+{
+    FetchTree_UTIL(TreeURL, PathPrefix, StartSync_UTIL(), nullptr);
+}
 
-                            FString RSSInitSubPath = TEXT("\\RSS\\RSSInit.json");
-                            FString RSSInitModule = TEXT("LifecycleInit");
-                            FString RSSInitField = TEXT("MacrosManager");
+// The function fetches git/trees recursively, keeps the blobs below PathPrefix in RemoteFiles and reports through OnRemoteTreeFetched;
+void UMacrosManager::FetchTree_UTIL(FString TreeURL, FString PathPrefix, TSharedRef<FHTTPCancellationToken> SyncToken, TFunction<void(bool bIsFetched)> OnFetched)
+{
+    UE_LOG(LogTemp, Warning, TEXT("Sending request to: %s"), *TreeURL);
 
-                            TArray<TSharedPtr<FJsonValue>> JsonArray = ThrowJsonArrayFromFile_UTIL(RSSInitSubPath);
-                            if (JsonArray.IsEmpty())
-                            {
-                                UE_LOG(LogTemp, Error, TEXT("RSSInit::JsonArray is empty - returning."));
-                                return;
-                            }
-                            
-                            TSharedPtr<FJsonObject> RSSMacrosManager = ThrowRSSInitModule_UTIL(JsonArray, RSSInitModule, RSSInitField);
-                            if (RSSMacrosManager == nullptr)
-                            {
-                                UE_LOG(LogTemp, Error, TEXT("RSSInit::MacrosManager is nullptr - returning."));
-                                return;
-                            }
+    // Interactive - a single request the sync waits for
+    FHTTPRequestOptions Options;
+    Options.Priority = EHTTPRequestPriority::Interactive;
+    Options.CancellationToken = SyncToken;
+
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+
+    // A tree addressed by its SHA never changes - an unchanged branch is answered with a free 304 from the cache
+    FHTTPRequestQueue::Get().EnqueueCoalesced(TreeURL,
+        [TreeURL](const FHttpRequestRef& Request)
+        {
+            FHTTPResponseCache::Get().ApplyValidators(TreeURL, Request);
+            FHTTPContentDecoder::ApplyAcceptEncoding(TreeURL, Request);
+            return true;
+        },
+        [WeakThis, TreeURL, PathPrefix, SyncToken, OnFetched](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+        {
+            // Reported as a failed listing - the sync waiting for it must still finish
+            if (!WeakThis.IsValid() || SyncToken->IsCancelled())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Sync cancelled - dropping: %s"), *TreeURL);
+                if (UMacrosManager* MacrosManager = WeakThis.Get())
+                {
+                    MacrosManager->OnRemoteTreeFetched.Broadcast(false, 0);
+                }
+                if (OnFetched)
+                {
+                    OnFetched(false);
+                }
+                return;
+            }
 
-                            RSSMacrosManager->SetNumberField(TEXT("SyncState"), 0);
-                            RSSMacrosManager->SetStringField(TEXT("RateLimit"), *RateLimit);
-                            RSSMacrosManager->SetStringField(TEXT("RateLimitResetAt"), *RateReset);
-                            RSSMacrosManager->SetNumberField(TEXT("ResponseCode"), 200);
+            // The listing of a large repository is a few megabytes of JSON - parsed on a worker
+            UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, TreeURL, PathPrefix, SyncToken, OnFetched, Response, bWasSuccessful]()
+            {
+                const double WorkerStartTime = FPlatformTime::Seconds();
+                FString ResponseStr;
+                TArray<FMacrosRemoteFile> Files;
+                const bool bIsFetched = bWasSuccessful
+                    && FHTTPResponseCache::Get().ResolveBodyAsString(TreeURL, Response, ResponseStr)
+                    && ParseTree_UTIL(ResponseStr, PathPrefix, Files);
+
+                if (!bIsFetched)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("FetchTree::Failed to fetch (%d): %s"), Response.IsValid() ? Response->GetResponseCode() : 0, *TreeURL);
+                }
 
-                            SaveJsonArrayToFile_UTIL(RSSInitSubPath, JsonArray);
+                FHTTPMetrics::Get().RecordWorker(TreeURL, FPlatformTime::Seconds() - WorkerStartTime);
 
-                            FString logBuild = FString::Printf(TEXT("All changes are synchronized."));
-                            CustomLog_TXT->SetText(FText::FromString(logBuild));
-                            UE_LOG(LogTemp, Warning, TEXT("The sync is not needed."));
+                AsyncTask(ENamedThreads::GameThread, [WeakThis, SyncToken, OnFetched, bIsFetched, Files = MoveTemp(Files)]() mutable
+                {
+                    UMacrosManager* MacrosManager = WeakThis.Get();
+                    if (MacrosManager == nullptr)
+                    {
+                        if (OnFetched)
+                        {
+                            OnFetched(false);
                         }
+                        return;
+                    }
+
+                    // Cancelled while parsing - the files of a stale listing aren't kept
+                    const bool bIsListed = bIsFetched && !SyncToken->IsCancelled();
+                    if (bIsListed)
+                    {
+                        MacrosManager->RemoteFiles = MoveTemp(Files);
+                        MacrosManager->CustomLog_FText_UTIL("FetchTree", FString::Printf(TEXT("%d remote files listed"), MacrosManager->RemoteFiles.Num()));
                     }
                     else
                     {
-                        UE_LOG(LogTemp, Error, TEXT("Commits.Num() is less or equal to 0"));
-                        return;
+                        MacrosManager->CustomLog_FText_UTIL("FetchTree", TEXT("Failed to list the remote files"));
                     }
+
+                    MacrosManager->OnRemoteTreeFetched.Broadcast(bIsListed, bIsListed ? MacrosManager->RemoteFiles.Num() : 0);
+                    if (OnFetched)
+                    {
+                        OnFetched(bIsListed);
+                    }
+                });
+            });
+        },
+        Options);
+}
+
+// The function turns a git/trees response into the blobs below PathPrefix - worker-safe;
+// GitHub cuts off trees above 100k entries / 7MB and flags them as truncated - a partial list would delete files in a delta sync, so it's refused;
+bool UMacrosManager::ParseTree_UTIL(const FString& ResponseStr, const FString& PathPrefix, TArray<FMacrosRemoteFile>& OutFiles)
+{
+    TSharedPtr<FJsonObject> TreeObject;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseStr);
+    if (!FJsonSerializer::Deserialize(Reader, TreeObject) || !TreeObject.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("FetchTree::Failed to deserialize the tree."));
+        return false;
+    }
+
+    bool bIsTruncated = false;
+    if (TreeObject->TryGetBoolField(TEXT("truncated"), bIsTruncated) && bIsTruncated)
+    {
+        UE_LOG(LogTemp, Error, TEXT("FetchTree::The tree is truncated - use the zipball sync for this repository."));
+        return false;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+    if (!TreeObject->TryGetArrayField(TEXT("tree"), Entries))
+    {
+        UE_LOG(LogTemp, Error, TEXT("FetchTree::The response has no tree field."));
+        return false;
+    }
+
+    for (const TSharedPtr<FJsonValue>& Value : *Entries)
+    {
+        const TSharedPtr<FJsonObject> Entry = Value.IsValid() ? Value->AsObject() : nullptr;
+
+        // Directories are implied by the paths of their blobs, submodules ("commit") have no content of ours
+        if (!Entry.IsValid() || Entry->GetStringField(TEXT("type")) != TEXT("blob"))
+        {
+            continue;
+        }
+
+        FString Path = Entry->GetStringField(TEXT("path"));
+        if (!PathPrefix.IsEmpty() && !Path.RemoveFromStart(PathPrefix, ESearchCase::CaseSensitive))
+        {
+            continue;
+        }
+
+        FMacrosRemoteFile& File = OutFiles.AddDefaulted_GetRef();
+        File.Path = Path;
+        File.Sha = Entry->GetStringField(TEXT("sha"));
+        Entry->TryGetNumberField(TEXT("size"), File.Size);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FetchTree::%d blobs below %s."), OutFiles.Num(), *PathPrefix);
+    return true;
+}
+
+// The function lists the remote tree, compares it against the local blob SHAs and transfers only the difference;
+void UMacrosManager::DeltaSync_SYNC(FString TreeURL, FString LocalFolderPath, FString PathPrefix)
+{
+    TSharedRef<FHTTPCancellationToken> SyncToken = StartSync_UTIL();
+    SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(1));
+
+    DeltaSync_UTIL(TreeURL, LocalFolderPath, PathPrefix, FString(), SyncToken);
+}
+
+// The function runs a delta sync under an already started SyncToken - CommitSha becomes the watermark if the tree belongs to a known commit;
+void UMacrosManager::DeltaSync_UTIL(FString TreeURL, FString LocalFolderPath, FString PathPrefix, FString CommitSha, TSharedRef<FHTTPCancellationToken> SyncToken)
+{
+    const int32 TreesIndex = TreeURL.Find(TEXT("/git/trees/"));
+    if (TreesIndex == INDEX_NONE)
+    {
+        FailDeltaSync_UTIL("DeltaSync", TEXT("TreeURL must point to a git/trees endpoint"), SyncToken);
+        return;
+    }
+    const FString BlobsURL = TreeURL.Left(TreesIndex) + TEXT("/git/blobs/");
+
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    FetchTree_UTIL(TreeURL, PathPrefix, SyncToken, [WeakThis, BlobsURL, LocalFolderPath, CommitSha, SyncToken](bool bIsFetched)
+    {
+        UMacrosManager* MacrosManager = WeakThis.Get();
+        if (MacrosManager == nullptr)
+        {
+            return;
+        }
+
+        if (!bIsFetched)
+        {
+            MacrosManager->FailDeltaSync_UTIL("DeltaSync", TEXT("Failed to list the remote files"), SyncToken);
+            return;
+        }
+
+        MacrosManager->PlanDeltaSync_UTIL(BlobsURL, LocalFolderPath, CommitSha, SyncToken);
+    });
+}
+
+// The function hashes the local files (index permitting) on a worker and splits the remote tree into downloads and deletions;
+void UMacrosManager::PlanDeltaSync_UTIL(FString BlobsURL, FString LocalFolderPath, FString CommitSha, TSharedRef<FHTTPCancellationToken> SyncToken)
+{
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, BlobsURL, LocalFolderPath, CommitSha, SyncToken, Remote = RemoteFiles]()
+    {
+        TSharedRef<FMacrosDeltaSyncState> State = MakeShared<FMacrosDeltaSyncState>();
+        State->LocalFolderPath = LocalFolderPath;
+        State->CommitSha = CommitSha;
+        State->Index = ScanLocalBlobs_UTIL(LocalFolderPath);
+
+        TSet<FString> RemotePaths;
+        TArray<FMacrosRemoteFile> ChangedFiles;
+        for (const FMacrosRemoteFile& File : Remote)
+        {
+            RemotePaths.Add(File.Path);
+
+            const FMacrosLocalBlob* Local = State->Index.Find(File.Path);
+            if (Local == nullptr || !Local->Sha.Equals(File.Sha, ESearchCase::IgnoreCase))
+            {
+                ChangedFiles.Add(File);
+            }
+        }
+
+        // An empty tree is far more likely a wrong prefix than a wiped repository - nothing gets deleted then
+        if (!Remote.IsEmpty())
+        {
+            for (const TPair<FString, FMacrosLocalBlob>& Pair : State->Index)
+            {
+                if (!RemotePaths.Contains(Pair.Key))
+                {
+                    State->RemovedPaths.Add(Pair.Key);
                 }
-                else
+            }
+        }
+
+        UE_LOG(LogTemp, Log, TEXT("DeltaSync::%d remote files - %d to download, %d to delete."), Remote.Num(), ChangedFiles.Num(), State->RemovedPaths.Num());
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, BlobsURL, SyncToken, State, ChangedFiles = MoveTemp(ChangedFiles)]() mutable
+        {
+            UMacrosManager* MacrosManager = WeakThis.Get();
+            if (MacrosManager == nullptr)
+            {
+                return;
+            }
+
+            if (SyncToken->IsCancelled())
+            {
+                MacrosManager->FailDeltaSync_UTIL("DeltaSync", TEXT("Sync cancelled"), SyncToken);
+                return;
+            }
+
+            MacrosManager->StartDeltaDownloads_UTIL(BlobsURL, MoveTemp(ChangedFiles), State, SyncToken);
+        });
+    });
+}
+
+// The function queues one blob download per changed file - each body streams to "<file>.part" and replaces the file only if its SHA matches;
+void UMacrosManager::StartDeltaDownloads_UTIL(FString BlobsURL, TArray<FMacrosRemoteFile> ChangedFiles, TSharedRef<FMacrosDeltaSyncState> State, TSharedRef<FHTTPCancellationToken> SyncToken)
+{
+    State->SyncToken = SyncToken;
+    State->Remaining = ChangedFiles.Num();
+    if (State->Remaining == 0)
+    {
+        FinishDeltaSync_UTIL(State);
+        return;
+    }
+
+    CustomLog_FText_UTIL("DeltaSync", FString::Printf(TEXT("Downloading %d changed files"), State->Remaining));
+
+    // Background - the queue keeps the fan-out within the per-host limits
+    FHTTPRequestOptions Options;
+    Options.Priority = EHTTPRequestPriority::Background;
+    Options.CancellationToken = SyncToken;
+    Options.bBuffersBody = false;
+
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+
+    for (const FMacrosRemoteFile& File : ChangedFiles)
+    {
+        const FString BlobURL = BlobsURL + File.Sha;
+        TSharedRef<FHTTPResponseStream> Stream = FHTTPResponseStream::CreateFileStream(State->LocalFolderPath / File.Path);
+        // The blob SHA covers the size - files listed by the compare endpoint come without one and are hashed once written
+        Stream->SetExpectedHash(EHTTPHashAlgorithm::GitBlobSHA1, File.Sha, File.Size);
+
+        FHTTPRequestQueue::Get().Enqueue(BlobURL,
+            [BlobURL, Stream](const FHttpRequestRef& Request)
+            {
+                // The raw media type skips the base64 JSON wrapper of the blobs endpoint
+                Request->SetHeader(TEXT("Accept"), TEXT("application/vnd.github.raw"));
+                if (FHTTPContentDecoder::ApplyAcceptEncoding(BlobURL, Request))
                 {
-                    UE_LOG(LogTemp, Error, TEXT("Failed to deserialize the JsonObject."));
-                    return;
+                    Stream->EnableContentDecoding(Request);
+                }
+                return Stream->IsValid() && Stream->Restart() && Request->SetResponseBodyReceiveStream(Stream);
+            },
+            [WeakThis, File, Stream, State](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+            {
+                const bool bIsOk = bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+
+                // Close, verify and move on a worker - only the bookkeeping returns to the game thread
+                UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, File, Stream, State, bIsOk]()
+                {
+                    const bool bIsCommitted = bIsOk && Stream->Commit();
+                    if (!bIsCommitted)
+                    {
+                        Stream->Discard();
+                        UE_LOG(LogTemp, Error, TEXT("DeltaSync::Failed to download %s (%s)."), *File.Path, *File.Sha);
+                    }
+
+                    FMacrosLocalBlob Blob;
+                    Blob.Sha = File.Sha;
+                    Blob.Size = IFileManager::Get().FileSize(*Stream->GetTargetPath());
+                    Blob.TimeStamp = IFileManager::Get().GetTimeStamp(*Stream->GetTargetPath());
+
+                    AsyncTask(ENamedThreads::GameThread, [WeakThis, File, State, bIsCommitted, Blob]()
+                    {
+                        if (bIsCommitted)
+                        {
+                            State->Index.Add(File.Path, Blob);
+                            State->NumDownloaded++;
+                        }
+                        else
+                        {
+                            // Hashed again next time
+                            State->Index.Remove(File.Path);
+                            State->NumFailed++;
+                        }
+
+                        UMacrosManager* MacrosManager = WeakThis.Get();
+                        if (--State->Remaining == 0 && MacrosManager != nullptr)
+                        {
+                            MacrosManager->FinishDeltaSync_UTIL(State);
+                        }
+                    });
+                });
+            },
+            Options);
+    }
+}
+
+// The function deletes the files removed remotely, writes the index back and reports the outcome;
+void UMacrosManager::FinishDeltaSync_UTIL(TSharedRef<FMacrosDeltaSyncState> State)
+{
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, State]()
+    {
+        int32 NumDeleted = 0;
+        for (const FString& Path : State->RemovedPaths)
+        {
+            if (IFileManager::Get().Delete(*(State->LocalFolderPath / Path), false, true, true))
+            {
+                State->Index.Remove(Path);
+                NumDeleted++;
+            }
+        }
+
+        SaveBlobIndex_UTIL(State->LocalFolderPath, State->Index);
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, State, NumDeleted]()
+        {
+            UMacrosManager* MacrosManager = WeakThis.Get();
+            if (MacrosManager == nullptr)
+            {
+                return;
+            }
+
+            const bool bIsSucceeded = State->NumFailed == 0;
+            MacrosManager->CustomLog_FText_UTIL("DeltaSync", FString::Printf(TEXT("%d files downloaded, %d deleted, %d failed"),
+                State->NumDownloaded, NumDeleted, State->NumFailed));
+
+            if (bIsSucceeded)
+            {
+                MacrosManager->SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(0));
+                UpdateRSSInit_UTIL("DeltaSync", [CommitSha = State->CommitSha](FJsonObject& RSSMacrosManager)
+                {
+                    RSSMacrosManager.SetNumberField(TEXT("SyncState"), 0);
+                    RSSMacrosManager.SetNumberField(TEXT("SyncDateTime"), FDateTime::UtcNow().ToUnixTimestamp());
+                    if (!CommitSha.IsEmpty())
+                    {
+                        RSSMacrosManager.SetStringField(SyncedCommitShaField, CommitSha);
+                    }
+                });
+            }
+            // Some files are still behind - unless a newer sync already shows its own progress
+            else if (!State->SyncToken.IsValid() || MacrosManager->OwnsSyncIndicator_UTIL(*State->SyncToken))
+            {
+                MacrosManager->SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(2));
+            }
+
+            MacrosManager->OnDeltaSyncFinished.Broadcast(bIsSucceeded, State->NumDownloaded, NumDeleted);
+        });
+    });
+}
+
+// The function reports a delta sync that ended before its downloads - failed or cancelled;
+void UMacrosManager::FailDeltaSync_UTIL(FString FunctionName, FString LogText, TSharedRef<FHTTPCancellationToken> SyncToken)
+{
+    CustomLog_FText_UTIL(FunctionName, LogText);
+
+    // Nothing was synced - the indicator falls back to "sync needed" unless a newer sync already shows its own progress
+    if (OwnsSyncIndicator_UTIL(*SyncToken))
+    {
+        SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(2));
+    }
+
+    OnDeltaSyncFinished.Broadcast(false, 0, 0);
+}
+
+// The function tells whether SyncToken still belongs to the running sync - or to the last one, if it was cancelled;
+bool UMacrosManager::OwnsSyncIndicator_UTIL(const FHTTPCancellationToken& SyncToken) const
+{
+    return !SyncCancellationToken.IsValid() || SyncCancellationToken.Get() == &SyncToken;
+}
+
+// The function reads the blob index of the previous sync - ignored if it belongs to another folder; worker-safe;
+TMap<FString, FMacrosLocalBlob> UMacrosManager::LoadBlobIndex_UTIL(const FString& LocalFolderPath)
+{
+    TMap<FString, FMacrosLocalBlob> PreviousIndex;
+    FString IndexString;
+    TSharedPtr<FJsonObject> IndexObject;
+    if (FFileHelper::LoadFileToString(IndexString, *GetBlobIndexPath_UTIL())
+        && FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(IndexString), IndexObject) && IndexObject.IsValid()
+        && IndexObject->GetStringField(TEXT("LocalFolderPath")) == LocalFolderPath)
+    {
+        const TSharedPtr<FJsonObject>* Files = nullptr;
+        if (IndexObject->TryGetObjectField(TEXT("Files"), Files))
+        {
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : (*Files)->Values)
+            {
+                const TSharedPtr<FJsonObject> Entry = Pair.Value->AsObject();
+                if (!Entry.IsValid())
+                {
+                    continue;
                 }
+
+                FMacrosLocalBlob& Blob = PreviousIndex.Add(Pair.Key);
+                Blob.Sha = Entry->GetStringField(TEXT("Sha"));
+                Blob.Size = static_cast<int64>(Entry->GetNumberField(TEXT("Size")));
+
+                // Ticks don't survive a double - stored as a string
+                int64 Ticks = 0;
+                LexFromString(Ticks, *Entry->GetStringField(TEXT("TimeStamp")));
+                Blob.TimeStamp = FDateTime(Ticks);
+            }
+        }
+    }
+
+    return PreviousIndex;
+}
+
+// The function returns the git blob SHA of every file below LocalFolderPath - worker-safe;
+// Files whose size and timestamp match the index keep their SHA, only new or touched files are read and hashed;
+TMap<FString, FMacrosLocalBlob> UMacrosManager::ScanLocalBlobs_UTIL(const FString& LocalFolderPath)
+{
+    const TMap<FString, FMacrosLocalBlob> PreviousIndex = LoadBlobIndex_UTIL(LocalFolderPath);
+
+    FString FolderPrefix = LocalFolderPath;
+    FPaths::NormalizeDirectoryName(FolderPrefix);
+    FolderPrefix += TEXT("/");
+
+    TArray<FString> FilePaths;
+    IFileManager::Get().FindFilesRecursive(FilePaths, *LocalFolderPath, TEXT("*"), true, false);
+
+    TMap<FString, FMacrosLocalBlob> Index;
+    int32 NumHashed = 0;
+    TArray<uint8> Buffer;
+    Buffer.SetNumUninitialized(64 * 1024);
+
+    for (FString FilePath : FilePaths)
+    {
+        FPaths::NormalizeFilename(FilePath);
+
+        FString RelativePath = FilePath;
+        if (!RelativePath.RemoveFromStart(FolderPrefix))
+        {
+            continue;
+        }
+
+        FMacrosLocalBlob Blob;
+        Blob.Size = IFileManager::Get().FileSize(*FilePath);
+        Blob.TimeStamp = IFileManager::Get().GetTimeStamp(*FilePath);
+
+        const FMacrosLocalBlob* Previous = PreviousIndex.Find(RelativePath);
+        if (Previous != nullptr && Previous->Size == Blob.Size && Previous->TimeStamp == Blob.TimeStamp)
+        {
+            Blob.Sha = Previous->Sha;
+            Index.Add(RelativePath, Blob);
+            continue;
+        }
+
+        // Streamed through the hasher in chunks - a large file is never loaded as a whole
+        TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+        if (!Reader.IsValid())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("DeltaSync::Failed to read %s - it will be downloaded again."), *FilePath);
+            continue;
+        }
+
+        FHTTPStreamHasher Hasher(EHTTPHashAlgorithm::GitBlobSHA1, Blob.Size);
+        for (int64 Remaining = Blob.Size; Remaining > 0 && !Reader->IsError(); )
+        {
+            const int32 ChunkSize = static_cast<int32>(FMath::Min<int64>(Remaining, Buffer.Num()));
+            Reader->Serialize(Buffer.GetData(), ChunkSize);
+            Hasher.Update(Buffer.GetData(), ChunkSize);
+            Remaining -= ChunkSize;
+        }
+
+        if (Reader->IsError())
+        {
+            continue;
+        }
+
+        Blob.Sha = Hasher.Finalize();
+        Index.Add(RelativePath, Blob);
+        NumHashed++;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("DeltaSync::%d local files, %d hashed, %d taken from the index."), Index.Num(), NumHashed, Index.Num() - NumHashed);
+    return Index;
+}
+
+// The function writes the blob index next to the other Saved data of the plugin - worker-safe;
+void UMacrosManager::SaveBlobIndex_UTIL(const FString& LocalFolderPath, const TMap<FString, FMacrosLocalBlob>& Index)
+{
+    TSharedRef<FJsonObject> Files = MakeShared<FJsonObject>();
+    for (const TPair<FString, FMacrosLocalBlob>& Pair : Index)
+    {
+        TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+        Entry->SetStringField(TEXT("Sha"), Pair.Value.Sha);
+        Entry->SetNumberField(TEXT("Size"), static_cast<double>(Pair.Value.Size));
+        Entry->SetStringField(TEXT("TimeStamp"), LexToString(Pair.Value.TimeStamp.GetTicks()));
+        Files->SetObjectField(Pair.Key, Entry);
+    }
+
+    TSharedRef<FJsonObject> IndexObject = MakeShared<FJsonObject>();
+    IndexObject->SetStringField(TEXT("LocalFolderPath"), LocalFolderPath);
+    IndexObject->SetObjectField(TEXT("Files"), Files);
+
+    FString IndexString;
+    FJsonSerializer::Serialize(IndexObject, TJsonWriterFactory<>::Create(&IndexString));
+    if (!FFileHelper::SaveStringToFile(IndexString, *GetBlobIndexPath_UTIL()))
+    {
+        UE_LOG(LogTemp, Error, TEXT("DeltaSync::Failed to write %s."), *GetBlobIndexPath_UTIL());
+    }
+}
+
+// The function downloads the files changed since the RSSInit watermark and deletes the removed ones - the local folder isn't hashed;
+void UMacrosManager::SyncSinceLastCommit_SYNC(FString RepositoryURL, FString LocalFolderPath, FString Branch, FString PathPrefix)
+{
+    RepositoryURL.RemoveFromEnd(TEXT("/"));
+
+    TSharedRef<FHTTPCancellationToken> SyncToken = StartSync_UTIL();
+    SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(1));
+
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    CompareWithWatermark_UTIL(RepositoryURL, Branch, PathPrefix, SyncToken,
+        [WeakThis, RepositoryURL, LocalFolderPath, PathPrefix, SyncToken](bool bIsCompared, TSharedRef<FMacrosCommitDiff> Diff)
+        {
+            UMacrosManager* MacrosManager = WeakThis.Get();
+            if (MacrosManager == nullptr)
+            {
+                return;
+            }
+
+            if (!bIsCompared)
+            {
+                MacrosManager->FailDeltaSync_UTIL("SyncSinceLastCommit", TEXT("Failed to resolve the remote changes"), SyncToken);
+                return;
             }
-            else
+
+            // The tree of the head commit - the compare answer is exact only from an ancestor of the head
+            if (!Diff->bIsComplete)
             {
-                UE_LOG(LogTemp, Error, TEXT("HTTP Response Code: %d"), Response->GetResponseCode());
-                UE_LOG(LogTemp, Error, TEXT("Request failed!"));
+                UE_LOG(LogTemp, Warning, TEXT("SyncSinceLastCommit::No exact diff since '%s' - syncing the whole tree of %s."), *Diff->BaseSha, *Diff->HeadSha);
+                MacrosManager->DeltaSync_UTIL(FString::Printf(TEXT("%s/git/trees/%s?recursive=1"), *RepositoryURL, *Diff->HeadSha), LocalFolderPath, PathPrefix, Diff->HeadSha, SyncToken);
                 return;
             }
+
+            UE_LOG(LogTemp, Log, TEXT("SyncSinceLastCommit::%s...%s - %d changed, %d removed."), *Diff->BaseSha, *Diff->HeadSha, Diff->ChangedFiles.Num(), Diff->RemovedPaths.Num());
+
+            // Only the index is loaded to be kept up to date - the diff already names every changed file
+            UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, RepositoryURL, LocalFolderPath, SyncToken, Diff]()
+            {
+                TSharedRef<FMacrosDeltaSyncState> State = MakeShared<FMacrosDeltaSyncState>();
+                State->LocalFolderPath = LocalFolderPath;
+                State->CommitSha = Diff->HeadSha;
+                State->Index = LoadBlobIndex_UTIL(LocalFolderPath);
+                State->RemovedPaths = Diff->RemovedPaths;
+
+                AsyncTask(ENamedThreads::GameThread, [WeakThis, RepositoryURL, SyncToken, Diff, State]()
+                {
+                    UMacrosManager* MacrosManager = WeakThis.Get();
+                    if (MacrosManager == nullptr)
+                    {
+                        return;
+                    }
+
+                    if (SyncToken->IsCancelled())
+                    {
+                        MacrosManager->FailDeltaSync_UTIL("SyncSinceLastCommit", TEXT("Sync cancelled"), SyncToken);
+                        return;
+                    }
+
+                    MacrosManager->StartDeltaDownloads_UTIL(RepositoryURL + TEXT("/git/blobs/"), Diff->ChangedFiles, State, SyncToken);
+                });
+            });
         });
+}
 
-    UE_LOG(LogTemp, Warning, TEXT("Sending request to: %s"), *Url);
-    Request->ProcessRequest();
+// The function answers whether a sync is needed from the commit SHAs - exact, no timestamps or time zones involved;
+void UMacrosManager::CheckRemoteChanges_SYNC(FString RepositoryURL, FString Branch, FString PathPrefix)
+{
+    RepositoryURL.RemoveFromEnd(TEXT("/"));
+
+    // Not part of a sync - CancelSync leaves a running check alone
+    TSharedRef<FHTTPCancellationToken> CheckToken = GetRequestsToken_UTIL()->CreateChild();
+
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    CompareWithWatermark_UTIL(RepositoryURL, Branch, PathPrefix, CheckToken, [WeakThis](bool bIsCompared, TSharedRef<FMacrosCommitDiff> Diff)
+    {
+        UMacrosManager* MacrosManager = WeakThis.Get();
+        if (MacrosManager == nullptr)
+        {
+            return;
+        }
+
+        if (!bIsCompared)
+        {
+            MacrosManager->CustomLog_FText_UTIL("CheckRemoteChanges", TEXT("Failed to resolve the remote changes"));
+            MacrosManager->OnRemoteChangesChecked.Broadcast(false, false, 0);
+            return;
+        }
+
+        // Without an exact diff only a full sync is safe
+        const int32 NumChangedFiles = Diff->ChangedFiles.Num() + Diff->RemovedPaths.Num();
+        const bool bIsSyncNeeded = !Diff->bIsComplete || NumChangedFiles > 0;
+
+        UpdateRSSInit_UTIL("CheckRemoteChanges", [bIsSyncNeeded](FJsonObject& RSSMacrosManager)
+        {
+            RSSMacrosManager.SetNumberField(TEXT("SyncState"), bIsSyncNeeded ? 2 : 0);
+        });
+
+        FString LogText = TEXT("All changes are synchronized");
+        if (!Diff->bIsComplete)
+        {
+            LogText = FString::Printf(TEXT("No exact diff since the last synced commit - a full sync to %s is needed"), *Diff->HeadSha.Left(7));
+        }
+        else if (bIsSyncNeeded)
+        {
+            LogText = FString::Printf(TEXT("%d files changed between %s and %s"), NumChangedFiles, *Diff->BaseSha.Left(7), *Diff->HeadSha.Left(7));
+        }
+
+        MacrosManager->CustomLog_FText_UTIL("CheckRemoteChanges", LogText);
+        MacrosManager->SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(bIsSyncNeeded ? 2 : 0));
+        MacrosManager->OnRemoteChangesChecked.Broadcast(true, bIsSyncNeeded, NumChangedFiles);
+    });
+}
+
+// The function resolves the head of Branch and diffs it against the watermark - an unchanged head costs a single SHA-only request;
+void UMacrosManager::CompareWithWatermark_UTIL(FString RepositoryURL, FString Branch, FString PathPrefix, TSharedRef<FHTTPCancellationToken> SyncToken, TFunction<void(bool bIsCompared, TSharedRef<FMacrosCommitDiff> CommitDiff)> OnCompared)
+{
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    ReadSyncedCommitSha_UTIL([WeakThis, RepositoryURL, Branch, PathPrefix, SyncToken, OnCompared](FString SyncedCommitSha)
+    {
+        // Every path ends in OnCompared - cancelled comparisons report a failure
+        if (!WeakThis.IsValid() || SyncToken->IsCancelled())
+        {
+            OnCompared(false, MakeShared<FMacrosCommitDiff>());
+            return;
+        }
+
+        const FString HeadURL = RepositoryURL + TEXT("/commits/") + Branch;
+        UE_LOG(LogTemp, Warning, TEXT("Sending request to: %s"), *HeadURL);
+
+        // Interactive - the sync indicator waits for it
+        FHTTPRequestOptions Options;
+        Options.Priority = EHTTPRequestPriority::Interactive;
+        Options.CancellationToken = SyncToken;
+        // The SHA media type answers with the 40 characters of the head only - and an unchanged head with a free 304;
+        // Passed as an option and to the cache - neither the queue nor the cache ever mixes it up with the JSON listing of the same URL
+        Options.Accept = TEXT("application/vnd.github.sha");
+
+        FHTTPRequestQueue::Get().EnqueueCoalesced(HeadURL,
+            [HeadURL, Accept = Options.Accept](const FHttpRequestRef& Request)
+            {
+                FHTTPResponseCache::Get().ApplyValidators(HeadURL, Request, Accept);
+                return true;
+            },
+            [WeakThis, RepositoryURL, HeadURL, Accept = Options.Accept, PathPrefix, SyncToken, OnCompared, SyncedCommitSha](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+            {
+                UMacrosManager* MacrosManager = WeakThis.Get();
+                if (MacrosManager == nullptr || SyncToken->IsCancelled())
+                {
+                    OnCompared(false, MakeShared<FMacrosCommitDiff>());
+                    return;
+                }
+
+                FString HeadSha;
+                const bool bIsResolved = bWasSuccessful && FHTTPResponseCache::Get().ResolveBodyAsString(HeadURL, Response, HeadSha, Accept);
+                HeadSha.TrimStartAndEndInline();
+
+                TSharedRef<FMacrosCommitDiff> Diff = MakeShared<FMacrosCommitDiff>();
+                if (!bIsResolved || HeadSha.Len() != 40)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("CompareWithWatermark::Failed to resolve the head (%d): %s"), Response.IsValid() ? Response->GetResponseCode() : 0, *HeadURL);
+                    OnCompared(false, Diff);
+                    return;
+                }
+
+                Diff->BaseSha = SyncedCommitSha;
+                Diff->HeadSha = HeadSha;
+
+                // No watermark yet - only a full sync can set one
+                if (SyncedCommitSha.IsEmpty())
+                {
+                    OnCompared(true, Diff);
+                    return;
+                }
+
+                if (SyncedCommitSha.Equals(HeadSha, ESearchCase::IgnoreCase))
+                {
+                    Diff->bIsComplete = true;
+                    OnCompared(true, Diff);
+                    return;
+                }
+
+                MacrosManager->CompareCommits_UTIL(RepositoryURL, Diff, PathPrefix, SyncToken, OnCompared);
+            },
+            Options);
+    });
+}
+
+// The function fetches compare/<BaseSha>...<HeadSha> and fills Diff with the paths below PathPrefix;
+void UMacrosManager::CompareCommits_UTIL(FString RepositoryURL, TSharedRef<FMacrosCommitDiff> Diff, FString PathPrefix, TSharedRef<FHTTPCancellationToken> SyncToken, TFunction<void(bool bIsCompared, TSharedRef<FMacrosCommitDiff> CommitDiff)> OnCompared)
+{
+    const FString CompareURL = FString::Printf(TEXT("%s/compare/%s...%s"), *RepositoryURL, *Diff->BaseSha, *Diff->HeadSha);
+    UE_LOG(LogTemp, Warning, TEXT("Sending request to: %s"), *CompareURL);
+
+    FHTTPRequestOptions Options;
+    Options.Priority = EHTTPRequestPriority::Interactive;
+    Options.CancellationToken = SyncToken;
+
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+
+    // Both ends are SHAs - the answer never changes, a repeated check is a free 304 from the cache
+    FHTTPRequestQueue::Get().EnqueueCoalesced(CompareURL,
+        [CompareURL](const FHttpRequestRef& Request)
+        {
+            FHTTPResponseCache::Get().ApplyValidators(CompareURL, Request);
+            FHTTPContentDecoder::ApplyAcceptEncoding(CompareURL, Request);
+            return true;
+        },
+        [WeakThis, CompareURL, Diff, PathPrefix, SyncToken, OnCompared](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+        {
+            if (!WeakThis.IsValid() || SyncToken->IsCancelled())
+            {
+                OnCompared(false, Diff);
+                return;
+            }
+
+            // The response carries a patch per file - parsed on a worker
+            UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, CompareURL, Diff, PathPrefix, SyncToken, OnCompared, Response, bWasSuccessful]()
+            {
+                const double WorkerStartTime = FPlatformTime::Seconds();
+                const int32 ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
+
+                bool bIsCompared = false;
+                FString ResponseStr;
+                if (bWasSuccessful && FHTTPResponseCache::Get().ResolveBodyAsString(CompareURL, Response, ResponseStr))
+                {
+                    bIsCompared = ParseCompare_UTIL(ResponseStr, PathPrefix, *Diff);
+                }
+                // The watermark commit is gone (force-push and garbage collection) - not a failure, the diff just can't be exact
+                else if (ResponseCode == EHttpResponseCodes::NotFound || ResponseCode == 422)
+                {
+                    bIsCompared = true;
+                    Diff->bIsComplete = false;
+                }
+
+                if (!bIsCompared)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("CompareCommits::Failed to compare (%d): %s"), ResponseCode, *CompareURL);
+                }
+
+                FHTTPMetrics::Get().RecordWorker(CompareURL, FPlatformTime::Seconds() - WorkerStartTime);
+
+                AsyncTask(ENamedThreads::GameThread, [WeakThis, SyncToken, OnCompared, Diff, bIsCompared]()
+                {
+                    OnCompared(bIsCompared && WeakThis.IsValid() && !SyncToken->IsCancelled(), Diff);
+                });
+            });
+        },
+        Options);
+}
+
+// The function turns a compare response into changed and removed paths below PathPrefix - worker-safe;
+// --> A renamed file is removed at its old path and downloaded at the new one;
+// --> A watermark that isn't an ancestor of the head, or a diff above the 300 files GitHub lists, leaves the diff incomplete;
+bool UMacrosManager::ParseCompare_UTIL(const FString& ResponseStr, const FString& PathPrefix, FMacrosCommitDiff& OutDiff)
+{
+    TSharedPtr<FJsonObject> CompareObject;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseStr);
+    if (!FJsonSerializer::Deserialize(Reader, CompareObject) || !CompareObject.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ParseCompare::Failed to deserialize the JsonObject."));
+        return false;
+    }
+
+    OutDiff.ChangedFiles.Reset();
+    OutDiff.RemovedPaths.Reset();
+    OutDiff.bIsComplete = false;
+
+    // "behind" / "diverged" - the branch was reset or force-pushed past the watermark
+    const FString Status = CompareObject->GetStringField(TEXT("status"));
+    if (Status != TEXT("ahead") && Status != TEXT("identical"))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ParseCompare::The head is %s of the synced commit."), *Status);
+        return true;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Files = nullptr;
+    if (!CompareObject->TryGetArrayField(TEXT("files"), Files))
+    {
+        OutDiff.bIsComplete = true;
+        return true;
+    }
+
+    constexpr int32 MaxCompareFiles = 300;
+    if (Files->Num() >= MaxCompareFiles)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ParseCompare::%d files listed - the diff may be cut off."), Files->Num());
+        return true;
+    }
+
+    for (const TSharedPtr<FJsonValue>& FileValue : *Files)
+    {
+        const TSharedPtr<FJsonObject> FileObject = FileValue->AsObject();
+        if (!FileObject.IsValid())
+        {
+            continue;
+        }
+
+        const FString FileStatus = FileObject->GetStringField(TEXT("status"));
+
+        FString PreviousPath;
+        if (FileStatus == TEXT("renamed") && FileObject->TryGetStringField(TEXT("previous_filename"), PreviousPath) && PreviousPath.RemoveFromStart(PathPrefix))
+        {
+            OutDiff.RemovedPaths.Add(PreviousPath);
+        }
+
+        FString Path = FileObject->GetStringField(TEXT("filename"));
+        if (!Path.RemoveFromStart(PathPrefix) || Path.IsEmpty() || FileStatus == TEXT("unchanged"))
+        {
+            continue;
+        }
+
+        if (FileStatus == TEXT("removed"))
+        {
+            OutDiff.RemovedPaths.Add(Path);
+            continue;
+        }
+
+        FMacrosRemoteFile& File = OutDiff.ChangedFiles.AddDefaulted_GetRef();
+        File.Path = Path;
+        File.Sha = FileObject->GetStringField(TEXT("sha"));
+        File.Size = INDEX_NONE;
+    }
+
+    OutDiff.bIsComplete = true;
+    return true;
+}
+
+// The function reads the watermark on the RSSInit pipe - pending updates land first; OnRead runs on the game thread;
+void UMacrosManager::ReadSyncedCommitSha_UTIL(TFunction<void(FString SyncedCommitSha)> OnRead)
+{
+    ReadRSSInit_UTIL("ReadSyncedCommitSha", [OnRead](TSharedPtr<FJsonObject> RSSMacrosManager)
+    {
+        FString SyncedCommitSha;
+        if (RSSMacrosManager != nullptr)
+        {
+            RSSMacrosManager->TryGetStringField(SyncedCommitShaField, SyncedCommitSha);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ReadSyncedCommitSha::No watermark - comparing without one."));
+        }
+
+        OnRead(SyncedCommitSha);
+    });
+}
+
+// The function syncs the whole Macros folder with one request instead of walking the contents API directory by directory;
+// The archive never touches the disk - it's either extracted while it streams in or straight from the response buffer;
+void UMacrosManager::SyncMacrosFromZipball(FString ZipballURL, FString LocalFolderPath, bool bExtractWhileDownloading)
+{
+    UE_LOG(LogTemp, Warning, TEXT("Sending request to: %s"), *ZipballURL);
+
+    // Interactive - started from SYNC_BTN, the user is waiting for this single request
+    FHTTPRequestOptions Options;
+    Options.Priority = EHTTPRequestPriority::Interactive;
+    TSharedRef<FHTTPCancellationToken> SyncToken = StartSync_UTIL();
+    Options.CancellationToken = SyncToken;
+
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+
+    // In progress - SyncProgress of the material is driven by TrackSyncProgress_UTIL
+    SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(1));
+
+    if (bExtractWhileDownloading)
+    {
+        // Decompression and disk writes overlap with the transfer - the HTTP thread feeds the extractor chunk by chunk
+        TSharedRef<FHTTPZipStreamExtractor> Extractor = FHTTPZipStreamExtractor::Create(TEXT("Macros/"), LocalFolderPath, true);
+        Options.bBuffersBody = false;
+        const int32 RequestId = FHTTPRequestQueue::Get().Enqueue(ZipballURL,
+            [Extractor](const FHttpRequestRef& Request)
+            {
+                // A retried request parses the archive from its first byte again
+                Extractor->Restart();
+                return Request->SetResponseBodyReceiveStream(Extractor);
+            },
+            [WeakThis, ZipballURL, Extractor, SyncToken](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+            {
+                TArray<FString> ExtractedFiles;
+                const bool bIsOk = bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+                const bool bIsExtracted = Extractor->Finish(ExtractedFiles) && bIsOk;
+
+                if (!bIsOk)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("SyncMacrosFromZipball::Failed to download: %s"), *ZipballURL);
+                }
+
+                if (UMacrosManager* MacrosManager = WeakThis.Get())
+                {
+                    MacrosManager->FinishZipballSync_UTIL(bIsExtracted, ExtractedFiles.Num(), SyncToken);
+                }
+            },
+            Options);
+        TrackSyncProgress_UTIL(RequestId);
+        return;
+    }
+
+    const int32 RequestId = UHTTPRequester::RequestBytes(ZipballURL, [WeakThis, ZipballURL, LocalFolderPath, SyncToken](bool bWasSuccessful, TArray<uint8>&& Content)
+    {
+        UMacrosManager* MacrosManager = WeakThis.Get();
+        if (MacrosManager == nullptr)
+        {
+            return;
+        }
+
+        if (!bWasSuccessful)
+        {
+            UE_LOG(LogTemp, Error, TEXT("SyncMacrosFromZipball::Failed to download: %s"), *ZipballURL);
+            MacrosManager->FinishZipballSync_UTIL(false, 0, SyncToken);
+            return;
+        }
+
+        // Inflating and writing the files runs on a worker - the editor keeps ticking while the archive is unpacked
+        UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, LocalFolderPath, SyncToken, Content = MoveTemp(Content)]() mutable
+        {
+            // The buffer moves into the zip stream - no copy between the socket and the zip reader
+            FHTTPZipMemoryStream Archive(MoveTemp(Content));
+
+            TArray<FString> ExtractedFiles;
+            const bool bIsExtracted = FHTTPZipExtractor::ExtractPrefix(Archive, TEXT("Macros/"), LocalFolderPath, true, ExtractedFiles);
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, bIsExtracted, SyncToken, NumFiles = ExtractedFiles.Num()]()
+            {
+                if (UMacrosManager* MacrosManager = WeakThis.Get())
+                {
+                    MacrosManager->FinishZipballSync_UTIL(bIsExtracted, NumFiles, SyncToken);
+                }
+            });
+        });
+    },
+    Options);
+    TrackSyncProgress_UTIL(RequestId);
+}
+
+// The function cancels every request of the running sync - crawl or zipball;
+void UMacrosManager::CancelSync()
+{
+    if (SyncCancellationToken.IsValid())
+    {
+        SyncCancellationToken->Cancel();
+        SyncCancellationToken.Reset();
+        CustomLog_FText_UTIL("CancelSync", TEXT("Sync cancelled"));
+    }
+}
+
+// The function returns the parent token of every request of this widget;
+TSharedRef<FHTTPCancellationToken> UMacrosManager::GetRequestsToken_UTIL()
+{
+    if (!RequestsToken.IsValid())
+    {
+        RequestsToken = FHTTPCancellationToken::Create();
+    }
+    return RequestsToken.ToSharedRef();
+}
+
+// The function replaces the token of the running sync - a new sync never races the previous one;
+TSharedRef<FHTTPCancellationToken> UMacrosManager::StartSync_UTIL()
+{
+    if (SyncCancellationToken.IsValid())
+    {
+        SyncCancellationToken->Cancel();
+    }
+
+    TSharedRef<FHTTPCancellationToken> Token = GetRequestsToken_UTIL()->CreateChild(SyncTimeout);
+    SyncCancellationToken = Token;
+    return Token;
+}
+
+// The function starts polling the download of the sync - throttled to SyncProgressIntervalMs;
+void UMacrosManager::TrackSyncProgress_UTIL(int32 RequestId)
+{
+    if (SyncProgressTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(SyncProgressTickerHandle);
+    }
+    SyncProgress = FHTTPProgressSample();
+
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+    SyncProgressTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, RequestId](float DeltaTime)
+    {
+        UMacrosManager* MacrosManager = WeakThis.Get();
+        return MacrosManager != nullptr && MacrosManager->TickSyncProgress_UTIL(RequestId);
+    }), FMath::Max(SyncProgressIntervalMs, 16) / 1000.0f);
+}
+
+// The function shows the received megabytes, the share of Content-Length and the rate - returns false once the download is over;
+bool UMacrosManager::TickSyncProgress_UTIL(int32 RequestId)
+{
+    int64 BytesReceived = 0;
+    int64 TotalBytes = -1;
+    if (!FHTTPRequestQueue::Get().GetProgress(RequestId, BytesReceived, TotalBytes))
+    {
+        // Still waiting for a slot - or already finished
+        if (FHTTPRequestQueue::Get().IsQueued(RequestId))
+        {
+            return true;
+        }
+
+        SyncProgressTickerHandle.Reset();
+        return false;
+    }
+
+    if (!SyncProgress.Update(BytesReceived, FPlatformTime::Seconds()))
+    {
+        return true;
+    }
+
+    const double ReceivedMB = BytesReceived / (1024.0 * 1024.0);
+    const double RateMB = SyncProgress.BytesPerSec / (1024.0 * 1024.0);
+
+    // GitHub streams zipballs without a Content-Length most of the time
+    FString Progress = TotalBytes > 0
+        ? FString::Printf(TEXT("Downloading %.1f / %.1f MB (%.1f MB/s)"), ReceivedMB, TotalBytes / (1024.0 * 1024.0), RateMB)
+        : FString::Printf(TEXT("Downloading %.1f MB (%.1f MB/s)"), ReceivedMB, RateMB);
+    CustomLog_FText_UTIL("SyncMacrosFromZipball", Progress);
+
+    // M_SyncNotify may expose a SyncProgress parameter - missing parameters are ignored
+    if (UMaterialInstanceDynamic* SyncMaterial = SyncImage->GetDynamicMaterial())
+    {
+        SyncMaterial->SetScalarParameterValue(FName("SyncProgress"), TotalBytes > 0 ? static_cast<float>(BytesReceived) / TotalBytes : 0.0f);
+    }
+
+    return true;
+}
+
+// The function reflects the outcome of a zipball sync in the widget and RSSInit;
+// --> The indicator is left alone once a newer sync took it over;
+void UMacrosManager::FinishZipballSync_UTIL(bool bIsSucceeded, int32 NumFiles, TSharedRef<FHTTPCancellationToken> SyncToken)
+{
+    const bool bOwnsIndicator = OwnsSyncIndicator_UTIL(*SyncToken);
+
+    if (!bIsSucceeded)
+    {
+        CustomLog_FText_UTIL("SyncMacrosFromZipball", FString::Printf(TEXT("Sync failed after %d files"), NumFiles));
+
+        // Failed or cancelled - the folder still needs a sync
+        if (bOwnsIndicator)
+        {
+            SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(2));
+        }
+        return;
+    }
+
+    if (bOwnsIndicator)
+    {
+        SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(0));
+    }
+    CustomLog_FText_UTIL("SyncMacrosFromZipball", FString::Printf(TEXT("%d files synchronized"), NumFiles));
+
+    UpdateRSSInit_UTIL("SyncMacrosFromZipball", [](FJsonObject& RSSMacrosManager)
+    {
+        RSSMacrosManager.SetNumberField(TEXT("SyncState"), 0);
+        RSSMacrosManager.SetNumberField(TEXT("SyncDateTime"), FDateTime::UtcNow().ToUnixTimestamp());
+    });
+}
+
+// void UMacrosManager::SearchInRepository(const FString &RepoOwner, const FString &RepoName, const FString &FolderPath)
+// {
+// 	// Build the API request URL
+// 	FString URL = FString::Printf(TEXT("https://api.github.com/repos/%s/%s/contents/Macros/%s"), 
+// 		*RepoOwner, *RepoName, *FolderPath);
+	
+// 	// Create the HTTP request
+// 	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+// 	Request->OnProcessRequestComplete().BindUObject(this, &UMacrosManager::OnSearchInRepositoryResponse);
+// 	Request->SetURL(URL);
+// 	Request->SetVerb(TEXT("GET"));
+// 	Request->ProcessRequest();
+// }
+
+// void UMacrosManager::OnSearchInRepositoryResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+// {
+// 	if (!bWasSuccessful || !Response.IsValid())
+// 	{
+// 		UE_LOG(LogTemp, Error, TEXT("Request failed or invalid response."));
+//         CustomLog_FText_UTIL("OnSearchInRepositoryResponse", "Request failed or invalid response - returning");
+// 		return;
+// 	}
+
+//     int32 ResponseCode = Response->GetResponseCode();
+//     if (ResponseCode == 200) // Folder exists
+//     {
+//         TArray<TSharedPtr<FJsonValue>> JsonArray;
+//         TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
+        
+//         if (FJsonSerializer::Deserialize(Reader, JsonArray))
+//         {
+//             UE_LOG(LogTemp, Log, TEXT("JSON Response contains %d items:"), JsonArray.Num());
+
+//             for (TSharedPtr<FJsonValue> Value : JsonArray)
+//             {
+//                 if (Value.IsValid() && Value->Type == EJson::Object)
+//                 {
+//                     TSharedPtr<FJsonObject> Object = Value->AsObject();
+//                     FString Name = Object->GetStringField(TEXT("name"));
+//                     FString Type = Object->GetStringField(TEXT("type"));
+        
+//                     UE_LOG(LogTemp, Log, TEXT("Name: %s, Type: %s"), *Name, *Type);
+//                 }
+//             }
+//         }
+//     }
+//     else if (ResponseCode == 404)
+//     {
+//         UE_LOG(LogTemp, Warning, TEXT("❌ Folder does NOT exist."));
+//         CustomLog_FText_UTIL("OnSearchInRepositoryResponse", "Folder does NOT exist.");
+//     }
+//     else
+//     {
+//         UE_LOG(LogTemp, Error, TEXT("Unexpected response: %d"), ResponseCode);
+//         CustomLog_FText_UTIL("OnSearchInRepositoryResponse", (TEXT("Unexpected response: ") + ResponseCode));
+//     }
+
+// 	// Check HTTP response code
+// 	int32 ResponseCode = Response->GetResponseCode();
+// 	if (ResponseCode == 200)
+// 	{
+// 		UE_LOG(LogTemp, Log, TEXT("✅ Folder exists!"));
+// 	}
+// 	else if (ResponseCode == 404)
+// 	{
+// 		UE_LOG(LogTemp, Warning, TEXT("❌ Folder does NOT exist."));
+// 	}
+// 	else
+// 	{
+// 		UE_LOG(LogTemp, Error, TEXT("Unexpected response: %d"), ResponseCode);
+// 	}
+// }
+
+// Reflects content to a text - bound to work in the editor utility widget blueprint;
+FString UMacrosManager::ReflectFileToScreen_UTIL(int32 CurrentIndex)
+{
+    FString Content;
+    FFileHelper::LoadFileToString(Content, *MacrossArray_FullPath[CurrentIndex]);
+
+    return Content;
+}
+
+// The function build custom log message - bound to work in the editor utility widget blueprint;
+void UMacrosManager::CustomLog_FText_UTIL(FString FunctionName, FString LogText)
+{
+    FString logBuild = CustomLogPrefix + FunctionName + TEXT("::") + LogText + TEXT(".");
+    CustomLog_TXT->SetText(FText::FromString(logBuild));
+}
+
+// The function checks when the last local changes were made;
+FDateTime UMacrosManager::CheckLocalChanges(FString LocalFolderPath)
+{
+    return GetLocalTimeStamp_UTIL(LocalFolderPath);
+}
+
+// The function reads the local timestamp without touching the widget - safe on worker tasks;
+FDateTime UMacrosManager::GetLocalTimeStamp_UTIL(const FString& LocalFolderPath)
+{
+    FDateTime LastModifiedUTC = IFileManager::Get().GetTimeStamp(*LocalFolderPath);
+    
+    // Convert to local time
+    FDateTime LastModifiedLocal = LastModifiedUTC + (FDateTime::Now() - FDateTime::UtcNow());
+
+    // FString LastModifiedStr = LastModifiedLocal.ToString();
+    // UE_LOG(LogTemp, Warning, TEXT("Last modified (Local Time): %s"), *LastModifiedStr);
+
+    return LastModifiedLocal;
+}
+
+// The function checks when the last changes were made in files on GitHub - kept for existing graphs, UMacrosSyncStatusAction returns the answer;
+void UMacrosManager::GetLastModifiedFromGitHub(FString RepositoryURL, FString LocalFolderPath, bool &bIsSyncNeeded)
+{
+    // Only known once the request completed - the reference is long gone by then
+    bIsSyncNeeded = false;
+
+    CheckSyncStatus_UTIL(RepositoryURL, LocalFolderPath, nullptr);
+}
+
+// The function fetches the commit listing, compares its first commit with the local timestamp and updates RSSInit and the widget;
+void UMacrosManager::CheckSyncStatus_UTIL(FString RepositoryURL, FString LocalFolderPath, TFunction<void(bool bIsChecked, const FMacrosSyncStatus& Status)> OnChecked)
+{
+    FString Url = RepositoryURL;
+
+    UE_LOG(LogTemp, Warning, TEXT("Sending request to: %s"), *Url);
+
+    // Interactive - the status check drives the sync indicator, it skips ahead of any running bulk crawl
+    FHTTPRequestOptions Options;
+    Options.Priority = EHTTPRequestPriority::Interactive;
+    Options.CancellationToken = GetRequestsToken_UTIL()->CreateChild();
+
+    TWeakObjectPtr<UMacrosManager> WeakThis(this);
+
+    // Reports on the game thread - the caller hears back whatever happened to the request
+    auto Finish = [OnChecked](bool bIsChecked, const FMacrosSyncStatus& Status)
+    {
+        if (!OnChecked)
+        {
+            return;
+        }
+
+        if (IsInGameThread())
+        {
+            OnChecked(bIsChecked, Status);
+            return;
+        }
+
+        AsyncTask(ENamedThreads::GameThread, [OnChecked, bIsChecked, Status]()
+        {
+            OnChecked(bIsChecked, Status);
+        });
+    };
+
+    // Coalesced - every widget asking for the commits endpoint at once (e.g. at editor start-up) shares one request
+    FHTTPRequestQueue::Get().EnqueueCoalesced(Url,
+        [Url](const FHttpRequestRef& Request)
+        {
+            FHTTPResponseCache::Get().ApplyValidators(Url, Request);
+            FHTTPContentDecoder::ApplyAcceptEncoding(Url, Request);
+            return true;
+        },
+        [WeakThis, Url, LocalFolderPath, Finish](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSuccess)
+        {
+            FMacrosSyncStatus Status;
+            Status.ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
+
+            // The widget was closed meanwhile - its requests were cancelled
+            if (!WeakThis.IsValid())
+            {
+                Finish(false, Status);
+                return;
+            }
+
+            if (!bSuccess || !Response.IsValid())
+            {
+                UE_LOG(LogTemp, Error, TEXT("HTTP Response Code: %d"), Status.ResponseCode);
+                UE_LOG(LogTemp, Error, TEXT("Request failed!"));
+                Finish(false, Status);
+                return;
+            }
+
+            // Parsing the listing, the local timestamp and RSSInit run on workers - only the widget is updated on the game thread
+            UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Url, LocalFolderPath, Response, Finish, Status]() mutable
+            {
+                UE_LOG(LogTemp, Warning, TEXT("HTTP Response Code: %d"), Status.ResponseCode);
+
+                FString RateLimit = Response->GetHeader("X-RateLimit-Remaining");
+                FString RateReset = Response->GetHeader("X-RateLimit-Reset");
+                UE_LOG(LogTemp, Warning, TEXT("Rate limit remaining: %s, resets at: %s"), *RateLimit, *RateReset);
+
+                if (!RateLimit.IsEmpty())
+                {
+                    LexFromString(Status.RateLimitRemaining, *RateLimit);
+                }
+                int64 RateResetUnix = 0;
+                if (!RateReset.IsEmpty() && LexTryParseString(RateResetUnix, *RateReset))
+                {
+                    Status.RateLimitResetAt = FDateTime::FromUnixTimestamp(RateResetUnix);
+                }
+
+                // A 304 reuses the cached commit listing - it doesn't count against the rate limit
+                FString ResponseStr;
+                if (!FHTTPResponseCache::Get().ResolveBodyAsString(Url, Response, ResponseStr))
+                {
+                    ResponseStr = Response->GetContentAsString();
+                }
+                // UE_LOG(LogTemp, Warning, TEXT("GitHub API Response: %s"), *ResponseStr);
+                
+                TArray<TSharedPtr<FJsonValue>> CommitArray;
+                TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseStr);                
+
+                if (!FJsonSerializer::Deserialize(Reader, CommitArray) || CommitArray.Num() <= 0)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Failed to deserialize the JsonObject."));
+                    Finish(false, Status);
+                    return;
+                }
+
+                UE_LOG(LogTemp, Warning, TEXT("The JsonObject was successfully serialazide."));
+
+                // Navigate the JSON structure to find the commit date
+                TSharedPtr<FJsonObject> CommitObject = CommitArray[0]->AsObject();
+                if (!CommitObject.IsValid())
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Commits.Num() is less or equal to 0"));
+                    Finish(false, Status);
+                    return;
+                }
+
+                // commit.author.date and sha - any of them missing means the response isn't a commit list
+                const TSharedPtr<FJsonObject>* CommitField = nullptr;
+                const TSharedPtr<FJsonObject>* AuthorField = nullptr;
+                FString DateString;
+                FString CommitSha;
+                FDateTime ParsedTime;
+                if (!CommitObject->TryGetObjectField(TEXT("commit"), CommitField)
+                    || !(*CommitField)->TryGetObjectField(TEXT("author"), AuthorField)
+                    || !(*AuthorField)->TryGetStringField(TEXT("date"), DateString)
+                    || !CommitObject->TryGetStringField(TEXT("sha"), CommitSha)
+                    || !FDateTime::ParseIso8601(*DateString, ParsedTime))
+                {
+                    UE_LOG(LogTemp, Error, TEXT("The latest commit misses its sha or author date."));
+                    Finish(false, Status);
+                    return;
+                }
+
+                FDateTime LocalTimeStamp = GetLocalTimeStamp_UTIL(LocalFolderPath);
+                FDateTime GitHubTimeStamp = ParsedTime + (FDateTime::Now() - FDateTime::UtcNow());
+
+                FTimespan Difference = GitHubTimeStamp - LocalTimeStamp;
+                const bool bIsBehind = GitHubTimeStamp > LocalTimeStamp && FMath::Abs(Difference.GetTotalMinutes()) > 2.0;
+
+                Status.bIsSyncNeeded = bIsBehind;
+                Status.LocalTimeStamp = LocalTimeStamp;
+                Status.RemoteTimeStamp = GitHubTimeStamp;
+                Status.RemoteCommitSha = CommitSha;
+
+                // Re-wrap into another function in order to change a single specific parameter
+                // Alternatively - set up RSSInit as completed only aftere sync
+                UpdateRSSInit_UTIL("CheckSyncStatus", [bIsBehind, RateLimit, RateReset](FJsonObject& RSSMacrosManager)
+                {
+                    RSSMacrosManager.SetNumberField(TEXT("SyncState"), bIsBehind ? 2 : 0);
+                    RSSMacrosManager.SetStringField(TEXT("RateLimit"), *RateLimit);
+                    RSSMacrosManager.SetStringField(TEXT("RateLimitResetAt"), *RateReset);
+                    RSSMacrosManager.SetNumberField(TEXT("ResponseCode"), 200);
+                });
+
+                if (bIsBehind)
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("Last Local Changes: %s"), *LocalTimeStamp.ToString());
+                    UE_LOG(LogTemp, Warning, TEXT("Last GitHub Commit: %s"), *GitHubTimeStamp.ToString());
+                }
+                else
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("The sync is not needed."));
+                }
+
+                FString logBuild = bIsBehind
+                    ? FString::Printf(TEXT("Last Local Changes: %s\nLast GitHub Commit: %s"), *LocalTimeStamp.ToString(), *GitHubTimeStamp.ToString())
+                    : FString::Printf(TEXT("All changes are synchronized."));
+
+                AsyncTask(ENamedThreads::GameThread, [WeakThis, bIsBehind, logBuild, Finish, Status]()
+                {
+                    UMacrosManager* MacrosManager = WeakThis.Get();
+                    if (MacrosManager != nullptr)
+                    {
+                        MacrosManager->CustomLog_TXT->SetText(FText::FromString(logBuild));
+                        MacrosManager->SyncImage->SetBrushFromMaterial(ThrowDynamicInstance(bIsBehind ? 2 : 0));
+                    }
+
+                    Finish(true, Status);
+                });
+            });
+        },
+        Options);
 }
 
 // The function is potentially deprecated - don't remember what it was designed for;
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MacrosSyncStatusAction.h"
+
+#include "Async/Async.h"
+
+UMacrosSyncStatusAction* UMacrosSyncStatusAction::CheckSyncStatus(UMacrosManager* InMacrosManager, FString InRepositoryURL, FString InLocalFolderPath)
+{
+	UMacrosSyncStatusAction* Action = NewObject<UMacrosSyncStatusAction>();
+	Action->MacrosManager = InMacrosManager;
+	Action->RepositoryURL = InRepositoryURL;
+	Action->LocalFolderPath = InLocalFolderPath;
+
+	return Action;
+}
+
+void UMacrosSyncStatusAction::Activate()
+{
+	// Released in Finish_UTIL - CheckSyncStatus_UTIL reports exactly once
+	AddToRoot();
+
+	TWeakObjectPtr<UMacrosSyncStatusAction> WeakThis(this);
+
+	UMacrosManager* Manager = MacrosManager.Get();
+	if (Manager == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("CheckSyncStatus::MacrosManager is nullptr - returning."));
+
+		// Never from inside Activate - the graph continues from the node's exec pin first, like with a real answer
+		AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+		{
+			if (UMacrosSyncStatusAction* Action = WeakThis.Get())
+			{
+				Action->Finish_UTIL(false, FMacrosSyncStatus());
+			}
+		});
+		return;
+	}
+
+	Manager->CheckSyncStatus_UTIL(RepositoryURL, LocalFolderPath, [WeakThis](bool bIsChecked, const FMacrosSyncStatus& Status)
+	{
+		if (UMacrosSyncStatusAction* Action = WeakThis.Get())
+		{
+			Action->Finish_UTIL(bIsChecked, Status);
+		}
+	});
+}
+
+void UMacrosSyncStatusAction::Finish_UTIL(bool bIsChecked, const FMacrosSyncStatus& Status)
+{
+	if (IsRooted())
+	{
+		RemoveFromRoot();
+	}
+
+	if (!bIsChecked)
+	{
+		OnFailed.Broadcast(Status);
+	}
+	else if (Status.bIsSyncNeeded)
+	{
+		OnSyncNeeded.Broadcast(Status);
+	}
+	else
+	{
+		OnUpToDate.Broadcast(Status);
+	}
+
+	SetReadyToDestroy();
+}
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Shared by every request of one logical operation (a sync, a crawl, a widget) - handed over through FHTTPRequestOptions;
+// --> Cancel() fails every pending and in-flight request of the token and of all its children;
+// --> The deadline is absolute - a child never outlives its parent, so requests spawned deep down a recursion still end in time;
+// Game thread only;
+class HTTPMANAGER_API FHTTPCancellationToken : public TSharedFromThis<FHTTPCancellationToken>
+{
+	public:
+
+	// Timeout - seconds from now until the requests of the token fail, 0 = no deadline of its own
+	static TSharedRef<FHTTPCancellationToken> Create(float Timeout = 0.0f);
+
+	// Cancelled together with this token and bound by its deadline
+	TSharedRef<FHTTPCancellationToken> CreateChild(float Timeout = 0.0f);
+
+	void Cancel();
+
+	// True once this token or any of its parents was cancelled
+	bool IsCancelled() const;
+
+	// FPlatformTime::Seconds() at which the requests fail - MAX_dbl without a deadline
+	double GetDeadline() const;
+
+	// True for the token itself and every token created below it
+	bool IsChildOf(const FHTTPCancellationToken& Ancestor) const;
+
+	private:
+
+	FHTTPCancellationToken() = default;
+
+	TSharedPtr<FHTTPCancellationToken> Parent;
+	double Deadline = MAX_dbl;
+	bool bIsCancelled = false;
+};
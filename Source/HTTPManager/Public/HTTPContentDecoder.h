@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+// HTTP Interfaces
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+struct z_stream_s;
+
+// Incremental gzip/zlib inflater for response bodies sent with Content-Encoding;
+// --> Only bodies whose response says Content-Encoding: gzip/deflate are inflated - a .gz payload or text that happens to start like
+//     a zlib header is handed over untouched;
+// --> Those bodies are sniffed on top - HTTP backends that already decode transparently keep their Content-Encoding header,
+//     so only bytes that actually start with a gzip/zlib header are inflated;
+// --> Raw deflate (no zlib wrapper) can't be told from plain data and is left alone - servers pick gzip whenever it's offered;
+// --> bIsRawDeflate - for callers that know the format up front, e.g. deflated zip entries;
+class HTTPMANAGER_API FHTTPContentDecoder
+{
+	public:
+
+	// Receives every decoded block - return false to abort decoding
+	using FSinkFunc = TFunctionRef<bool(const uint8* Data, int64 Num)>;
+
+	explicit FHTTPContentDecoder(bool bInIsRawDeflate = false);
+	~FHTTPContentDecoder();
+
+	FHTTPContentDecoder(const FHTTPContentDecoder&) = delete;
+	FHTTPContentDecoder& operator=(const FHTTPContentDecoder&) = delete;
+
+	// Needs at least MinSniffSize bytes
+	static bool IsCompressed(const uint8* Data, int64 Num);
+	static constexpr int32 MinSniffSize = 2;
+
+	// Inflates the next chunk - false on corrupted data or when the sink gave up
+	// --> OutConsumed - input bytes that belonged to the compressed stream, less than Num once a raw deflate stream ended;
+	bool Decode(const uint8* Data, int64 Num, FSinkFunc Sink, int64* OutConsumed = nullptr);
+
+	// True once the last gzip member / zlib / deflate stream was closed properly
+	bool IsFinished() const { return bIsFinished; }
+
+	// Whole-buffer variant for bodies that stayed in the response - bodies that aren't encoded or compressed are copied as they are
+	static bool DecodeBody(const TArray<uint8>& Body, bool bIsEncoded, TArray<uint8>& OutBody);
+
+	// Whether a Content-Encoding value / the response names gzip or deflate
+	static bool IsContentEncoded(const FString& ContentEncoding);
+	static bool IsContentEncoded(const FHttpResponsePtr& Response);
+
+	// Asks the server for a compressed body - skipped for URLs whose resource is a gzip file itself, returns whether the header was set
+	static bool ApplyAcceptEncoding(const FString& URL, const FHttpRequestRef& Request);
+	static bool ShouldDecode(const FString& URL);
+
+	private:
+
+	// Advances Data/Num past the consumed input
+	bool DecodeInternal(const uint8*& Data, int64& Num, FSinkFunc Sink);
+
+	TUniquePtr<z_stream_s> Stream;
+	TArray<uint8> OutputBuffer;
+	bool bIsRawDeflate = false;
+	bool bIsInitialized = false;
+	bool bIsFinished = false;
+};
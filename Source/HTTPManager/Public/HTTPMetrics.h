@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HTTPMetrics.generated.h"
+
+// Phases of a request as measured by FHTTPRequestQueue
+UENUM(BlueprintType)
+enum class EHTTPTimingPhase : uint8
+{
+	// Enqueue until the first attempt was sent - slots, priorities, rate limits
+	Queue,
+	// Send until the response headers arrived - server think time and network latency
+	TimeToFirstByte,
+	// Response headers until the request finished - body download, streamed decoding included
+	Transfer,
+	// Our completion callbacks on the game thread - the worker tasks they launch are measured as Worker
+	Process,
+	// Worker tasks processing a response, as reported by the worker itself - decoding, hashing, JSON parsing, file writes
+	Worker,
+	// Enqueue until the completion callbacks returned, retries included - Worker runs after that and isn't part of it
+	Total
+};
+
+// Summary of one histogram - all times in milliseconds
+USTRUCT(BlueprintType)
+struct FHTTPTimingStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="HTTP Utilities|Metrics")
+	int32 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="HTTP Utilities|Metrics")
+	float Min = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="HTTP Utilities|Metrics")
+	float Avg = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="HTTP Utilities|Metrics")
+	float P50 = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="HTTP Utilities|Metrics")
+	float P95 = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="HTTP Utilities|Metrics")
+	float P99 = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="HTTP Utilities|Metrics")
+	float Max = 0.0f;
+};
+
+// Timestamps of one finished request - FPlatformTime::Seconds(), 0 where the phase never happened
+struct FHTTPRequestTimings
+{
+	double EnqueueTime = 0.0;
+	double FirstSendTime = 0.0;
+	// Of the last attempt
+	double SendTime = 0.0;
+	double FirstByteTime = 0.0;
+	double CompleteTime = 0.0;
+	double ProcessSeconds = 0.0;
+	bool bWasSuccessful = false;
+};
+
+// Process-wide request timing histograms - one series per host and one per endpoint ("<host><normalized path>");
+// --> Log-scale buckets (~9% wide) from 0.1ms to ~20min, memory stays constant however many requests are recorded;
+// --> Percentiles are reported as the bucket midpoint, clamped to the observed min/max;
+// Game thread only, except RecordWorker;
+class HTTPMANAGER_API FHTTPMetrics
+{
+	public:
+
+	static FHTTPMetrics& Get();
+
+	void RecordRequest(const FString& URL, const FString& Host, const FHTTPRequestTimings& Timings);
+
+	// Any thread - recorded on the game thread, URL is the one the request was enqueued with
+	void RecordWorker(const FString& URL, double Seconds);
+
+	bool GetStats(const FString& Key, EHTTPTimingPhase Phase, FHTTPTimingStats& OutStats) const;
+	TArray<FString> GetKeys() const;
+
+	// One row per series and phase - Key,Phase,Count,Failures,MinMs,AvgMs,P50Ms,P95Ms,P99Ms,MaxMs
+	FString ToCSV() const;
+	bool ExportCSV(const FString& FilePath) const;
+
+	void Reset();
+
+	// Drops the query and everything past the first four path segments, hashes and numbers become ":id" -
+	// e.g. https://api.github.com/repos/o/r/contents/Macros/A.txt -> /repos/o/r/contents
+	static FString GetEndpoint(const FString& URL);
+
+	private:
+
+	struct FHistogram
+	{
+		TArray<int32> Buckets;
+		int64 Count = 0;
+		double Sum = 0.0;
+		double Min = MAX_dbl;
+		double Max = 0.0;
+
+		void Add(double Seconds);
+		double GetPercentile(double Percentile) const;
+	};
+
+	struct FSeries
+	{
+		FHistogram Phases[static_cast<int32>(EHTTPTimingPhase::Total) + 1];
+		int64 Failures = 0;
+	};
+
+	void RecordSeries(const FString& Key, const FHTTPRequestTimings& Timings);
+
+	TMap<FString, FSeries> Series;
+};
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Delegates/Delegate.h"
+// HTTP Interfaces
+#include "Interfaces/IHttpResponse.h"
+
+// Host, requests left in the current window, Unix seconds at which the window resets
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnRateLimitUpdated, const FString& /*Host*/, int32 /*Remaining*/, int64 /*ResetAt*/);
+
+// Process-wide token bucket per host - every request of FHTTPRequestQueue takes a token right before it is sent;
+// --> Only hosts that reported X-RateLimit-* headers (or were seeded) have a bucket, everything else is unlimited;
+// --> The bucket spends the remaining budget evenly over the rest of the window, with BurstSize tokens available at once;
+// --> Responses correct the local count - exhaustion is known before sending instead of from a failed call;
+// Game thread only;
+class HTTPMANAGER_API FHTTPRateLimiter
+{
+	public:
+
+	static FHTTPRateLimiter& Get();
+
+	// Seeds or corrects the budget of the host - Limit 0 means unknown, the bucket is dropped once the window resets
+	void Update(const FString& Host, int32 Limit, int32 Remaining, int64 ResetAt);
+	void UpdateFromResponse(const FString& Host, const FHttpResponsePtr& Response);
+
+	// Seconds until the host has a token - 0 for hosts without a bucket;
+	// --> bIgnorePacing - interactive requests only wait for an exhausted budget, not for the even spread over the window;
+	double GetWaitTime(const FString& Host, bool bIgnorePacing = false) const;
+
+	// Takes one token - called right before the request is sent
+	void Acquire(const FString& Host);
+
+	bool GetBudget(const FString& Host, int32& OutRemaining, int64& OutResetAt) const;
+
+	void SetBurstSize(int32 InBurstSize) { BurstSize = FMath::Max(InBurstSize, 1); }
+
+	// Broadcast whenever a server response or a seed changes the budget - not for local token spending
+	FOnRateLimitUpdated OnRateLimitUpdated;
+
+	private:
+
+	struct FBucket
+	{
+		int32 Limit = 0;
+		int32 Remaining = 0;
+		int64 ResetAt = 0;
+
+		double Tokens = 0.0;
+		// FPlatformTime::Seconds() of the last refill
+		double LastRefill = 0.0;
+	};
+
+	// Tokens the bucket holds at the current time - doesn't modify the bucket
+	double GetAvailableTokens(const FBucket& Bucket) const;
+	double GetRefillRate(const FBucket& Bucket) const;
+
+	// Starts a new window if the old one has passed - false if the bucket should be dropped
+	bool RollWindow(FBucket& Bucket) const;
+
+	TMap<FString, FBucket> Buckets;
+	int32 BurstSize = 20;
+};
@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HTTPRequestPriority.generated.h"
+
+// Scheduling class of a request - FHTTPRequestQueue always sends the highest class first, FIFO within a class
+UENUM(BlueprintType)
+enum class EHTTPRequestPriority : uint8
+{
+	// Bulk sync traffic - crawls, batch downloads, zipballs
+	Background,
+	Normal,
+	// Triggered by the user and waited for in the UI - may use the slots reserved for interactive work
+	Interactive
+};
@@ -0,0 +1,314 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "HTTPCancellationToken.h"
+#include "HTTPRequestPriority.h"
+#include "HTTPRetryPolicy.h"
+// HTTP Interfaces
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+#include <atomic>
+
+// Called right before the request is sent - attach streams/headers here, return false to fail the request without sending it
+using FHTTPQueueSetupFunc = TFunction<bool(const FHttpRequestRef& Request)>;
+
+// Called once the request left the queue - always on the game thread and never from inside Enqueue
+using FHTTPQueueCompleteFunc = TFunction<void(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)>;
+
+// Per-request settings of Enqueue - everything left at its default behaves like a plain GET
+struct FHTTPRequestOptions
+{
+	FString Verb = TEXT("GET");
+	EHTTPRequestPriority Priority = EHTTPRequestPriority::Normal;
+
+	// Sent as the Accept header - empty leaves it to OnSetup / the backend;
+	// --> Part of the EnqueueCoalesced key, so requests for different representations of a URL never share a response;
+	FString Accept;
+
+	// Seconds until the response headers arrive / the whole attempt finishes - below 0 uses the queue default, 0 disables;
+	// --> A timed out attempt counts as a connection error and goes through the retry policy;
+	float ConnectTimeout = -1.0f;
+	float Timeout = -1.0f;
+
+	// Cancels the request together with the rest of its operation - its deadline is the only hard cap of the request
+	TSharedPtr<FHTTPCancellationToken> CancellationToken;
+
+	// False for requests whose OnSetup attaches a file stream - they keep nothing in memory and ignore the memory budget
+	bool bBuffersBody = true;
+
+	// Charged against the memory budget until the Content-Length header arrives - 0 uses the queue default
+	int64 ExpectedBodySize = 0;
+
+	// Used instead of OnSetup once the memory budget is exhausted - attaches a file stream, so the request is sent right away instead of waiting;
+	// --> Ignored by EnqueueCoalesced - followers read the body from the response;
+	FHTTPQueueSetupFunc OnSpoolSetup;
+};
+
+// Keeps a body that is still being processed (e.g. decoded on a worker task) charged against the memory budget of FHTTPRequestQueue;
+// --> Released when the last reference goes away - from any thread;
+class HTTPMANAGER_API FHTTPBufferHold
+{
+	public:
+
+	explicit FHTTPBufferHold(int64 InBytes);
+	~FHTTPBufferHold();
+
+	private:
+
+	int64 Bytes = 0;
+};
+
+// Throttled transfer rate of one download - fed with its byte count once per progress interval
+struct FHTTPProgressSample
+{
+	int64 BytesReceived = 0;
+	double Time = 0.0;
+	float BytesPerSec = 0.0f;
+
+	// False while nothing new arrived since the previous sample
+	bool Update(int64 InBytesReceived, double Now)
+	{
+		if (Time > 0.0 && InBytesReceived == BytesReceived)
+		{
+			return false;
+		}
+
+		if (Time > 0.0 && Now > Time)
+		{
+			// A retry starts over from 0 - no negative rates
+			const float Rate = static_cast<float>(FMath::Max<int64>(InBytesReceived - BytesReceived, 0) / (Now - Time));
+			// Smoothed - a single slow interval doesn't make the number jump
+			BytesPerSec = BytesPerSec > 0.0f ? FMath::Lerp(BytesPerSec, Rate, 0.5f) : Rate;
+		}
+
+		BytesReceived = InBytesReceived;
+		Time = Now;
+		return true;
+	}
+};
+
+struct FHTTPQueuedFollower
+{
+	int32 RequestId = INDEX_NONE;
+	FHTTPQueueCompleteFunc OnComplete;
+	TSharedPtr<FHTTPCancellationToken> CancellationToken;
+};
+
+struct FHTTPQueuedRequest
+{
+	int32 RequestId = INDEX_NONE;
+	FString URL;
+	FString Verb = TEXT("GET");
+	FString Host;
+	FString Accept;
+	EHTTPRequestPriority Priority = EHTTPRequestPriority::Normal;
+
+	FHTTPQueueSetupFunc OnSetup;
+	FHTTPQueueCompleteFunc OnComplete;
+
+	// Coalesced requests - identical GETs (URL and Accept) issued while this one is queued ride along and get the same response
+	FString CoalesceKey;
+	TArray<FHTTPQueuedFollower> Followers;
+
+	// Valid only while the request is in flight
+	FHttpRequestPtr HttpRequest;
+
+	// Resolved per request - 0 means no timeout
+	float ConnectTimeout = 0.0f;
+	float Timeout = 0.0f;
+	TSharedPtr<FHTTPCancellationToken> CancellationToken;
+
+	// Memory budget - see FHTTPRequestOptions
+	bool bBuffersBody = true;
+	int64 ExpectedBodySize = 0;
+	FHTTPQueueSetupFunc OnSpoolSetup;
+	// Sticky - every retry of a spooled request spools as well
+	bool bIsSpooled = false;
+	// Content-Length of the current attempt - stamped from the HTTP thread, -1 until the header arrives
+	TSharedPtr<std::atomic<int64>, ESPMode::ThreadSafe> ContentLength;
+	// Bytes the current attempt received so far - stamped by OnRequestProgress64
+	TSharedPtr<std::atomic<int64>, ESPMode::ThreadSafe> BytesReceived;
+
+	// FPlatformTime::Seconds() at which the first / current attempt was sent - recorded into FHTTPMetrics on completion
+	double FirstSendTime = 0.0;
+	double SendTime = 0.0;
+	// Stamped when the response headers of the current attempt arrive - possibly from the HTTP thread
+	TSharedPtr<std::atomic<double>, ESPMode::ThreadSafe> FirstByteTime;
+	bool bIsCancelled = false;
+	bool bIsTimedOut = false;
+
+	// Retries - OnSetup runs again for every attempt, OnComplete only for the final one
+	FHTTPRetryPolicy RetryPolicy;
+	int32 AttemptsMade = 0;
+	double EnqueueTime = 0.0;
+	double NotBefore = 0.0;
+
+	// Hard cap - only a cancellation token deadline ends a running transfer or a rate limit wait
+	double GetDeadline() const
+	{
+		return CancellationToken.IsValid() ? CancellationToken->GetDeadline() : MAX_dbl;
+	}
+
+	// Bounds the backoff schedule - RetryPolicy.Deadline on top of the hard cap
+	double GetRetryDeadline() const
+	{
+		const double PolicyDeadline = RetryPolicy.Deadline > 0.0f ? EnqueueTime + RetryPolicy.Deadline : MAX_dbl;
+		return FMath::Min(PolicyDeadline, GetDeadline());
+	}
+
+	bool IsCancelled() const { return bIsCancelled || (CancellationToken.IsValid() && CancellationToken->IsCancelled()); }
+};
+
+// Process-wide HTTP scheduler - every request goes through a single pending list and is sent only while a slot is free;
+// --> MaxInFlight - global cap of simultaneously running requests;
+// --> MaxInFlightPerHost - cap per domain, keeps bulk syncs below GitHub's secondary rate limits;
+// --> The pending list is ordered by EHTTPRequestPriority - ReservedSlots (global and per host) are kept free for interactive requests,
+//     so a click in the UI is sent right away even while a bulk crawl saturates the host;
+// --> Failed requests are retried according to FHTTPRetryPolicy, a host that reported an exhausted rate limit is parked until the reset;
+// --> Requests to rate limited hosts wait for a token of FHTTPRateLimiter;
+// --> A watchdog ticker runs while anything is queued - it cancels attempts past their timeouts and requests past their token deadline;
+// --> Cancelled requests complete with bWasSuccessful = false, a coalesced request keeps running as long as someone still waits for it;
+// --> Every finished request feeds its queue wait, TTFB, transfer and completion callback times into FHTTPMetrics;
+// --> Bodies kept in memory share MemoryBudget - in-flight responses (Content-Length, or an estimate until it arrives) and FHTTPBufferHold;
+//     once it's spent, buffered requests wait for memory to be released or are spooled to disk if they provide OnSpoolSetup;
+// Game thread only - FHTTPBufferHold may be released from any thread;
+class HTTPMANAGER_API FHTTPRequestQueue
+{
+	public:
+
+	static FHTTPRequestQueue& Get();
+
+	// Returns the request ID - the request is sent as soon as the limits allow it
+	int32 Enqueue(const FString& URL, FHTTPQueueSetupFunc OnSetup, FHTTPQueueCompleteFunc OnComplete, const FHTTPRequestOptions& Options = FHTTPRequestOptions());
+
+	// Same as Enqueue, but joins an identical GET that is already pending or in flight instead of sending a new one;
+	// --> Only for requests whose body stays in the response - OnSetup of a joining caller is ignored, it must not attach a stream;
+	// --> Every caller still gets its own request ID;
+	// --> A joining caller with a higher priority raises the priority of the shared request;
+	// --> Options.Verb is ignored, timeouts of a joining caller as well;
+	int32 EnqueueCoalesced(const FString& URL, FHTTPQueueSetupFunc OnSetup, FHTTPQueueCompleteFunc OnComplete, const FHTTPRequestOptions& Options = FHTTPRequestOptions());
+
+	// Fails the request - false if it isn't queued anymore; OnComplete still runs, on the next tick at the latest
+	bool Cancel(int32 RequestId);
+
+	// Cancels every request of the token and of its children - called by FHTTPCancellationToken::Cancel
+	void CancelByToken(const FHTTPCancellationToken& Token);
+
+	void SetMaxInFlight(int32 InMaxInFlight, int32 InMaxInFlightPerHost);
+	int32 GetMaxInFlight() const { return MaxInFlight; }
+	int32 GetMaxInFlightPerHost() const { return MaxInFlightPerHost; }
+
+	// Slots only interactive requests may take - the other classes always keep at least one slot
+	void SetReservedSlots(int32 InReservedSlots, int32 InReservedSlotsPerHost);
+	int32 GetReservedSlots() const { return ReservedSlots; }
+	int32 GetReservedSlotsPerHost() const { return ReservedSlotsPerHost; }
+
+	// Applied to requests whose options leave the timeouts at their default - 0 disables
+	void SetDefaultTimeouts(float InConnectTimeout, float InTimeout);
+	float GetDefaultConnectTimeout() const { return DefaultConnectTimeout; }
+	float GetDefaultTimeout() const { return DefaultTimeout; }
+
+	// Bytes of response bodies kept in memory at once, 0 disables - a single request larger than the budget is still sent once nothing else is buffered
+	void SetMemoryBudget(int64 InMemoryBudget);
+	int64 GetMemoryBudget() const { return MemoryBudget; }
+
+	// In-flight buffered responses plus every FHTTPBufferHold
+	int64 GetBufferedBytes() const;
+
+	TSharedRef<FHTTPBufferHold, ESPMode::ThreadSafe> HoldBuffer(int64 Bytes);
+
+	// Only valid inside a completion callback - the charge of the buffered body shared by the request and everyone who joined it;
+	// --> Keep a reference while the body is still processed elsewhere, instead of holding the same bytes once per caller;
+	TSharedPtr<FHTTPBufferHold, ESPMode::ThreadSafe> GetCompletingBufferHold() const;
+
+	// Applies to requests enqueued from now on
+	void SetRetryPolicy(const FHTTPRetryPolicy& InRetryPolicy) { RetryPolicy = InRetryPolicy; }
+	const FHTTPRetryPolicy& GetRetryPolicy() const { return RetryPolicy; }
+
+	// Seconds until the host accepts requests again - 0 if it isn't parked
+	double GetHostParkedFor(const FString& Host) const;
+
+	int32 GetNumPending() const { return Pending.Num(); }
+	int32 GetNumInFlight() const { return InFlight.Num(); }
+
+	// True while the request is either pending or in flight
+	bool IsQueued(int32 RequestId) const;
+
+	// Bytes the current attempt received and its Content-Length (-1 while unknown) - false unless the request is in flight;
+	// --> Followers report the progress of the request they joined;
+	bool GetProgress(int32 RequestId, int64& OutBytesReceived, int64& OutTotalBytes) const;
+
+	private:
+
+	TSharedPtr<FHTTPQueuedRequest> AddEntry(const FString& URL, FHTTPQueueSetupFunc OnSetup, FHTTPQueueCompleteFunc OnComplete, const FHTTPRequestOptions& Options);
+
+	// Keeps Pending sorted by priority - bAtFront puts the entry ahead of its own class (retries), otherwise behind it
+	void InsertPending(const TSharedPtr<FHTTPQueuedRequest>& Entry, bool bAtFront);
+	TSharedPtr<FHTTPQueuedRequest> FindEntry(int32 RequestId) const;
+	TArray<TSharedPtr<FHTTPQueuedRequest>> GetAllEntries() const;
+	void CompleteEntry(const TSharedPtr<FHTTPQueuedRequest>& Entry, FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	void CompleteEntryDeferred(const TSharedPtr<FHTTPQueuedRequest>& Entry, FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	static void FailDeferred(FHTTPQueueCompleteFunc OnComplete);
+
+	void CancelEntry(const TSharedPtr<FHTTPQueuedRequest>& Entry);
+	void EnsureWatchdog();
+	bool CheckTimeouts();
+
+	void PumpQueue();
+	bool CanDispatch(const FHTTPQueuedRequest& Entry) const;
+	int64 GetBufferCharge(const FHTTPQueuedRequest& Entry) const;
+	bool FitsMemoryBudget(const FHTTPQueuedRequest& Entry) const;
+	void ReleaseBuffer(int64 Bytes);
+	double GetReadyTime(const FHTTPQueuedRequest& Entry) const;
+	void ScheduleWakeUp(double WakeUpTime);
+	void ParkHost(const FString& Host, const FHttpResponsePtr& Response);
+	void Dispatch(const TSharedPtr<FHTTPQueuedRequest>& Entry);
+	void ReleaseHostSlot(const FString& Host);
+	void OnRequestFinished(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId);
+
+	TArray<TSharedPtr<FHTTPQueuedRequest>> Pending;
+	TMap<int32, TSharedPtr<FHTTPQueuedRequest>> InFlight;
+	TMap<FString, int32> InFlightPerHost;
+
+	// Coalesce key -> ID of the request the followers are attached to
+	TMap<FString, int32> CoalescedRequests;
+
+	// Host -> FPlatformTime::Seconds() at which it accepts requests again
+	TMap<FString, double> ParkedHosts;
+
+	FHTTPRetryPolicy RetryPolicy;
+
+	// Pumps the queue once the earliest parked request becomes ready
+	FTSTicker::FDelegateHandle WakeUpTickerHandle;
+	double WakeUpTime = 0.0;
+
+	FTSTicker::FDelegateHandle WatchdogTickerHandle;
+	float DefaultConnectTimeout = 30.0f;
+	float DefaultTimeout = 0.0f;
+
+	int32 MaxInFlight = 8;
+	int32 MaxInFlightPerHost = 4;
+	int32 ReservedSlots = 2;
+	int32 ReservedSlotsPerHost = 1;
+	int32 NextRequestId = 1;
+
+	int64 MemoryBudget = 256 * 1024 * 1024;
+	// Charged for a buffered request that neither set ExpectedBodySize nor sent a Content-Length yet
+	int64 DefaultBodySize = 1024 * 1024;
+	std::atomic<int64> HeldBytes = 0;
+	// Set while CompleteEntry fans a buffered response out to its callbacks
+	TSharedPtr<FHTTPBufferHold, ESPMode::ThreadSafe> CompletingBufferHold;
+	// Releases from worker threads pump the queue once per tick at most
+	std::atomic<bool> bIsReleasePumpScheduled = false;
+
+	friend class FHTTPBufferHold;
+
+	// Guards against re-entrant pumping from completion callbacks
+	bool bIsPumping = false;
+	bool bPumpRequested = false;
+};
@@ -10,27 +10,238 @@
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Interfaces/IHttpResponse.h"
+#include "HTTPMetrics.h"
+#include "HTTPRequestPriority.h"
+#include "HTTPRequestQueue.h"
+#include "HTTPStreamHasher.h"
 #include "HTTPRequester.generated.h"
 
+class FHTTPResponseStream;
+class FHTTPSegmentedDownload;
+
 // Dynamic delegate that Blueprints can pass as a custom event
 DECLARE_DYNAMIC_DELEGATE_OneParam(FOnDownloadResponse, const FString&, FileContent);
 
+// Binary-safe variant - delivers the raw body, no FString conversion (zip archives, images)
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnDownloadBytesResponse, bool, bWasSuccessful, const TArray<uint8>&, Content);
+
+// C++ consumers take ownership of the body - e.g. move it into an FHTTPZipMemoryStream
+using FHTTPBytesCompleteFunc = TFunction<void(bool bWasSuccessful, TArray<uint8>&& Content)>;
+
+// Broadcasted for every finished request - lets Blueprints match results against the returned request ID
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnRequestCompleted, int32, RequestId, bool, bWasSuccessful, const FString&, FileContent);
+
+// Throttled to ProgressIntervalMs - TotalBytes is -1 while the server hasn't announced a size
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnDownloadProgress, int32, RequestId, int64, BytesReceived, int64, TotalBytes, float, BytesPerSec);
+
+// Fired once every request of a DownloadFiles batch has finished
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(FOnDownloadBatchComplete, int32, BatchId, int32, SucceededCount, const TArray<FString>&, FailedURLs);
+
+// Per-request state - every DownloadFile call owns its callback, so concurrent calls never overwrite each other
+struct FHTTPRequestContext
+{
+	int32 RequestId = INDEX_NONE;
+	// ID of the queued request - differs from RequestId once a segmented download fell back to a single request
+	int32 QueueRequestId = INDEX_NONE;
+	int32 BatchId = INDEX_NONE;
+	FString URL;
+	EHTTPRequestPriority Priority = EHTTPRequestPriority::Normal;
+	// Child of the requester's token - CancelRequest cancels it, including every segment of a segmented download
+	TSharedPtr<FHTTPCancellationToken> CancellationToken;
+	FOnDownloadResponse Callback;
+
+	// Binary mode - the raw body bytes are handed to BytesCallback
+	bool bReceiveBytes = false;
+	FOnDownloadBytesResponse BytesCallback;
+
+	// In-memory bodies are written to SavePath only if asked for
+	bool bSaveToFile = false;
+
+	// Set while a streamed download is in flight
+	bool bStreamToDisk = false;
+	TSharedPtr<FHTTPResponseStream> ResponseStream;
+	FString SavePath;
+
+	// Verified before the body is committed / saved - None skips hashing
+	EHTTPHashAlgorithm HashAlgorithm = EHTTPHashAlgorithm::None;
+	FString ExpectedHash;
+	// Blob size of GitBlobSHA1 on streamed downloads - in-memory bodies use their own size
+	int64 ExpectedSize = 0;
+
+	// Set while a large file is fetched as parallel byte ranges
+	TSharedPtr<FHTTPSegmentedDownload, ESPMode::ThreadSafe> SegmentedDownload;
+
+	// Last OnDownloadProgress event
+	FHTTPProgressSample Progress;
+};
+
+// Outcome of the worker-side half of OnResponseReceived
+struct FHTTPProcessedResponse
+{
+	bool bIsOk = false;
+	// Text body or saved path
+	FString FileContent;
+	// Binary mode only
+	TArray<uint8> Content;
+};
+
+struct FHTTPBatchContext
+{
+	int32 Remaining = 0;
+	int32 SucceededCount = 0;
+	TArray<FString> FailedURLs;
+	FOnDownloadBatchComplete Callback;
+};
+
 UCLASS()
 class HTTPMANAGER_API UHTTPRequester : public UEditorUtilityWidget
 {
 	GENERATED_BODY()
-	
+
+	protected:
+	// Requests of a closed widget are cancelled - nobody is left to consume them
+	virtual void NativeDestruct() override;
+
 	public:
 	
-	// Function to start downloading (now accepts a Blueprint event)
-	UFUNCTION(BlueprintCallable, Category="HTTP Utilities", meta = (AdvancedDisplay = "bSaveToFile"))
-	void DownloadFile(const FString& URL, bool bSaveToFile, FOnDownloadResponse Callback);
+	// Function to start downloading (now accepts a Blueprint event) - returns the request ID, INDEX_NONE if the request couldn't be started
+	// --> bStreamToDisk - the body is written to SavePath chunk by chunk as it arrives and the callback receives the saved path instead of the content;
+	// --> bSaveToFile - in-memory bodies are saved to SavePath as well, streamed bodies always are;
+	// --> SavePath - empty falls back to <ProjectSavedDir>/HTTPDownloads/DownloadedFile_<GUID>.txt, unique per call so concurrent downloads never share a file;
+	// --> With bUseSegmentedDownloads, streamed files above SegmentedDownloadThreshold are fetched as parallel byte ranges and resume after an interruption;
+	// --> HashAlgorithm - the body is hashed while it arrives and only committed / saved if it matches ExpectedHash (e.g. a manifest MD5 or a GitHub blob SHA);
+	//     hashed downloads are never split into segments, the ranges arrive out of order;
+	// --> ExpectedSize - the "size" GitHub reports along with the blob SHA, needed by GitBlobSHA1 when streaming to disk;
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities", meta = (AdvancedDisplay = "bSaveToFile,bStreamToDisk,SavePath,HashAlgorithm,ExpectedHash,ExpectedSize"))
+	int32 DownloadFile(const FString& URL, bool bSaveToFile, FOnDownloadResponse Callback, bool bStreamToDisk = false, const FString& SavePath = TEXT(""),
+		EHTTPHashAlgorithm HashAlgorithm = EHTTPHashAlgorithm::None, const FString& ExpectedHash = TEXT(""), int64 ExpectedSize = 0);
+
+	// Binary-safe download - the body is delivered as bytes exactly as received; returns the request ID
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities")
+	int32 DownloadBytes(const FString& URL, FOnDownloadBytesResponse Callback);
+
+	// C++ only - the response buffer is moved into OnComplete without being copied or converted
+	// --> Once the memory budget is spent the body is spooled to Saved/HTTPSpool instead of waiting, and read back on completion;
+	static int32 RequestBytes(const FString& URL, FHTTPBytesCompleteFunc OnComplete, const FHTTPRequestOptions& Options = FHTTPRequestOptions());
+
+	// Queues every URL through the shared scheduler and fires BatchCallback once all of them have finished - returns the batch ID
+	// --> SaveDirectory - each body is streamed to <SaveDirectory>/<URL path without host and query>; empty keeps the bodies in memory (see OnRequestCompleted);
+	// --> URLs that would leave SaveDirectory or share a file with an earlier URL of the batch are reported as failed without being sent;
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities")
+	int32 DownloadFiles(const TArray<FString>& URLs, const FString& SaveDirectory, FOnDownloadBatchComplete BatchCallback);
+
+	// Limits applied to every request sent through the requester - global and per host
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities")
+	void SetDownloadConcurrency(int32 MaxInFlight = 8, int32 MaxInFlightPerHost = 4);
+
+	// Slots kept free for Interactive requests - global and per host, the other priorities always keep at least one slot
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities|Scheduling")
+	void SetReservedSlots(int32 ReservedSlots = 2, int32 ReservedSlotsPerHost = 1);
+
+	// Response bodies kept in memory at once, 0 disables - further in-memory requests wait, streamed ones are never held back
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities|Scheduling")
+	void SetMemoryBudget(int32 MaxBufferedMB = 256);
+
+	UFUNCTION(BlueprintPure, Category="HTTP Utilities|Scheduling")
+	int32 GetBufferedMemoryMB() const;
+
+	// Default timeouts of every attempt in seconds, 0 disables - ConnectTimeout runs until the response headers arrive;
+	// --> A timed out attempt is retried like a connection error;
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities")
+	void SetRequestTimeouts(float ConnectTimeout = 30.0f, float Timeout = 0.0f);
+
+	// The callback still fires, with bWasSuccessful = false - returns false if the request already finished
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities")
+	bool CancelRequest(int32 RequestId);
+
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities")
+	void CancelAllRequests();
+
+	// Connection errors, 5xx and 429 are retried with exponential backoff - Deadline (seconds, 0 = none) caps the retry schedule, not a running transfer
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities")
+	void SetRetryPolicy(int32 MaxAttempts = 4, float BaseDelay = 1.0f, float MaxDelay = 30.0f, float Deadline = 0.0f);
+
+	// Size cap of the on-disk response cache (Saved/HTTPCache) - least recently used bodies are evicted first
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities|Cache")
+	void SetResponseCacheSize(int32 MaxSizeMB = 256);
+
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities|Cache")
+	void ClearResponseCache();
+
+	// Timing histograms of every request sent through the shared queue - Key is a host or "<host><endpoint>" from GetRequestTimingKeys
+	UFUNCTION(BlueprintPure, Category="HTTP Utilities|Metrics")
+	bool GetRequestTimingStats(const FString& Key, EHTTPTimingPhase Phase, FHTTPTimingStats& OutStats) const;
+
+	UFUNCTION(BlueprintPure, Category="HTTP Utilities|Metrics")
+	TArray<FString> GetRequestTimingKeys() const;
+
+	// FilePath - empty falls back to <ProjectSavedDir>/HTTPMetrics/RequestTimings.csv
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities|Metrics")
+	bool ExportRequestTimingsCSV(const FString& FilePath = TEXT(""));
+
+	UFUNCTION(BlueprintCallable, Category="HTTP Utilities|Metrics")
+	void ResetRequestTimings();
+
+	UFUNCTION(BlueprintPure, Category="HTTP Utilities")
+	bool IsRequestActive(int32 RequestId) const;
+
+	UFUNCTION(BlueprintPure, Category="HTTP Utilities")
+	TArray<int32> GetActiveRequestIds() const;
+
+	UPROPERTY(BlueprintAssignable, Category="HTTP Utilities")
+	FOnRequestCompleted OnRequestCompleted;
+
+	// Fired for every active request that received data since its previous event - at most once per ProgressIntervalMs
+	UPROPERTY(BlueprintAssignable, Category="HTTP Utilities|Progress")
+	FOnDownloadProgress OnDownloadProgress;
+
+	// Applies from the next request started while none is active
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="HTTP Utilities|Progress", meta = (ClampMin = "16"))
+	int32 ProgressIntervalMs = 100;
+
+	// Scheduling class of DownloadFile/DownloadBytes - set Interactive for calls the user is waiting for
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="HTTP Utilities|Scheduling")
+	EHTTPRequestPriority RequestPriority = EHTTPRequestPriority::Normal;
+
+	// Scheduling class of DownloadFiles batches
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="HTTP Utilities|Scheduling")
+	EHTTPRequestPriority BatchPriority = EHTTPRequestPriority::Background;
+
+	// Segmented downloads - streamed DownloadFile calls probe Accept-Ranges/Content-Length first;
+	// --> Off by default - the probe is an extra round trip and an extra request against the rate limit for every file;
+	// --> Skipped for calls whose ExpectedSize is already known to be below SegmentedDownloadThreshold;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="HTTP Utilities|Segmented Downloads")
+	bool bUseSegmentedDownloads = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="HTTP Utilities|Segmented Downloads", meta = (ClampMin = "1", ClampMax = "16"))
+	int32 DownloadSegmentCount = 4;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="HTTP Utilities|Segmented Downloads", meta = (ClampMin = "0"))
+	int64 SegmentedDownloadThreshold = 8 * 1024 * 1024;
 
 
 	private:
-	// Store the callback to call later
-	FOnDownloadResponse DownloadResponseDelegate;
+	// Store the callbacks to call later - keyed by request ID
+	TMap<int32, TSharedPtr<FHTTPRequestContext>> ActiveRequests;
+	TMap<int32, FHTTPBatchContext> ActiveBatches;
+	int32 NextBatchId = 1;
+
+	// Parent of every request token - cancelled as a whole by CancelAllRequests
+	TSharedPtr<FHTTPCancellationToken> RequestsToken;
+
+	// Polls the active requests while there are any - a single ticker per widget, however many downloads run
+	FTSTicker::FDelegateHandle ProgressTickerHandle;
+	void EnsureProgressTicker();
+	bool TickProgress();
+
+	TSharedRef<FHTTPRequestContext> CreateContext(const FString& URL, EHTTPRequestPriority Priority);
+	FHTTPRequestOptions MakeRequestOptions(const FHTTPRequestContext& Context) const;
 
 
-	void OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	int32 StartRequest(const TSharedRef<FHTTPRequestContext>& Context);
+	int32 StartSegmentedRequest(const TSharedRef<FHTTPRequestContext>& Context);
+	void OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TSharedRef<FHTTPRequestContext> Context);
+	static void ProcessResponse(const FHTTPRequestContext& Context, const FHttpResponsePtr& Response, bool bWasSuccessful, FHTTPProcessedResponse& OutResult);
+	void FinishResponse(FHTTPRequestContext& Context, FHTTPProcessedResponse& Result);
+	void CompleteRequest(FHTTPRequestContext& Context, bool bWasSuccessful, const FString& FileContent);
 };
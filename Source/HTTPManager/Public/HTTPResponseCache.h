@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+// HTTP Interfaces
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+struct FHTTPCacheEntry
+{
+	FString ETag;
+	FString LastModified;
+
+	// SHA-1 of the body - names the blob, identical bodies from different URLs share a single file
+	FString ContentHash;
+	int64 Size = 0;
+
+	// Unix seconds of the last store or hit - eviction order
+	int64 LastAccess = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FHTTPCacheEntry& Entry)
+	{
+		Ar << Entry.ETag << Entry.LastModified << Entry.ContentHash << Entry.Size << Entry.LastAccess;
+		return Ar;
+	}
+};
+
+// Persistent conditional GET cache - remembers ETag/Last-Modified per URL and the body they belong to;
+// --> The next request for the URL carries If-None-Match/If-Modified-Since, a 304 answer reuses the stored body;
+// --> GitHub doesn't count 304 responses against the rate limit, so polling through the cache is nearly free;
+// --> Lives in <ProjectSaved>/HTTPCache/ - a binary CacheIndex.bin plus content-addressed bodies under Blobs/;
+// --> The total size of the blobs is capped, least recently used URLs are evicted first;
+// --> Accept - the media type the request asked for; every representation of a URL has its own entry, as Vary: Accept demands;
+// Thread-safe - responses are resolved on worker tasks, every public call holds CacheLock;
+class HTTPMANAGER_API FHTTPResponseCache
+{
+	public:
+
+	static FHTTPResponseCache& Get();
+
+	~FHTTPResponseCache();
+
+	// Adds the validators if a body for the URL is cached
+	void ApplyValidators(const FString& URL, const FHttpRequestRef& Request, const FString& Accept = FString());
+
+	// Stores the body of a 2xx response - responses without ETag/Last-Modified are skipped
+	void Store(const FString& URL, const FHttpResponsePtr& Response, const TArray<uint8>& Body, const FString& Accept = FString());
+
+	bool LoadBody(const FString& URL, TArray<uint8>& OutBody, const FString& Accept = FString());
+
+	// Returns the fresh body on 2xx (decoded and stored) or the cached one on 304 - false for anything else;
+	// --> Accept has to be the one ApplyValidators got - a 304 is only valid for the representation it revalidated;
+	bool ResolveBody(const FString& URL, const FHttpResponsePtr& Response, TArray<uint8>& OutBody, const FString& Accept = FString());
+	bool ResolveBodyAsString(const FString& URL, const FHttpResponsePtr& Response, FString& OutBody, const FString& Accept = FString());
+
+	static bool IsNotModified(const FHttpResponsePtr& Response);
+
+	// UTF-8 body to FString - same result as IHttpResponse::GetContentAsString
+	static FString BytesToString(const TArray<uint8>& Body);
+
+	void SetMaxSize(int64 InMaxSizeBytes);
+	int64 GetMaxSize() const;
+
+	// Size of the unique blobs on disk
+	int64 GetTotalSize() const;
+	int32 GetNumEntries() const;
+
+	void Clear();
+
+	private:
+
+	// URL alone for the default representation
+	static FString GetEntryKey(const FString& URL, const FString& Accept);
+
+	FString GetCacheDir() const;
+	FString GetBlobPath(const FString& ContentHash) const;
+
+	void LoadIndex();
+	void SaveIndex();
+	void MarkDirty();
+
+	void AddBlobReference(const FHTTPCacheEntry& Entry);
+	void ReleaseBlobReference(const FHTTPCacheEntry& Entry);
+	void RemoveEntry(const FString& URL);
+	void EvictToFit();
+
+	TMap<FString, FHTTPCacheEntry> Entries;
+
+	// Content hash -> number of URLs pointing at the blob
+	TMap<FString, int32> BlobReferences;
+	int64 TotalBlobSize = 0;
+	int64 MaxSizeBytes = 256 * 1024 * 1024;
+
+	bool bIsIndexLoaded = false;
+	FTSTicker::FDelegateHandle SaveTickerHandle;
+
+	// Recursive - ResolveBody goes through LoadBody and Store
+	mutable FCriticalSection CacheLock;
+};
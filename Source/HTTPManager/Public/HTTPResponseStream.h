@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+#include "HTTPContentDecoder.h"
+#include "HTTPStreamHasher.h"
+
+#include <atomic>
+
+// Archive handed over to IHttpRequest::SetResponseBodyReceiveStream - the HTTP thread pushes the body into it chunk by chunk;
+// --> File mode - chunks go straight to a ".part" file next to the target, memory stays flat regardless of the payload size;
+// --> The ".part" file replaces the target only after Commit(), so a failed download never clobbers an existing file;
+// --> Memory mode - raw bytes are collected into a single buffer which ReleaseBody() moves out, no FString conversion and no extra copy;
+// --> With content decoding enabled, bodies sent with Content-Encoding gzip/deflate are inflated chunk by chunk on their way in - both modes store the decoded body;
+// --> With a hash set, the decoded body is hashed as it's written and Commit() refuses a body that doesn't match - no second read to verify;
+class HTTPMANAGER_API FHTTPResponseStream : public FArchive, public TSharedFromThis<FHTTPResponseStream, ESPMode::ThreadSafe>
+{
+	public:
+
+	// Opens "<TargetPath>.part" for writing - check IsValid() before handing the stream to a request
+	static TSharedRef<FHTTPResponseStream> CreateFileStream(const FString& TargetPath);
+
+	// Collects the body in memory - ExpectedSize only pre-sizes the buffer
+	static TSharedRef<FHTTPResponseStream> CreateMemoryStream(int64 ExpectedSize = 0);
+
+	virtual ~FHTTPResponseStream();
+
+	bool IsValid() const;
+
+	bool IsMemoryStream() const { return !bIsFileStream; }
+
+	// Inflates bodies the response marks with Content-Encoding - call from the setup of every attempt that sent Accept-Encoding;
+	// --> Hooks the header callback of Request, and falls back to the response headers once the first body bytes arrive;
+	void EnableContentDecoding(const FHttpRequestRef& Request);
+
+	// Hashes the decoded body with Algorithm - a non-empty ExpectedHash is verified by Commit(); call before handing the stream to a request
+	// --> BlobSize - content size for EHTTPHashAlgorithm::GitBlobSHA1, below 0 when unknown - the body is then hashed after Close() instead of while streaming;
+	void SetExpectedHash(EHTTPHashAlgorithm Algorithm, const FString& InExpectedHash, int64 BlobSize = 0);
+
+	// Lowercase hex digest of the committed body - empty before Commit() or without a hash
+	const FString& GetComputedHash() const { return ComputedHash; }
+
+	// Flushes and closes the writer, then moves the ".part" file over the target - fails without touching the target if the hash doesn't match
+	bool Commit();
+
+	// Closes the writer and deletes the ".part" file - memory streams drop their buffer
+	void Discard();
+
+	// Drops whatever a previous attempt received - a retried request starts over with an empty body / truncated ".part" file
+	bool Restart();
+
+	// Memory mode only - moves the received body out of the stream, the stream is empty afterwards
+	TArray<uint8> ReleaseBody();
+
+	// Bytes as they came over the wire - before decoding
+	int64 GetBytesReceived() const { return BytesReceived.load(); }
+	const FString& GetTargetPath() const { return TargetPath; }
+
+	// FArchive interface
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual bool Close() override;
+	virtual int64 Tell() override { return BytesReceived.load(); }
+	virtual int64 TotalSize() override { return BytesReceived.load(); }
+	virtual FString GetArchiveName() const override { return TEXT("FHTTPResponseStream"); }
+
+	private:
+
+	FHTTPResponseStream();
+
+	// Both called with WriterLock held
+	void ConsumeBody(const uint8* Data, int64 Num);
+	bool WriteBody(const uint8* Data, int64 Num);
+	void FinishDecoding();
+
+	// Finalizes the hash once the body is complete - a mismatch flags the stream as failed
+	bool VerifyHash();
+
+	// GitBlobSHA1 of the body as written - reads the closed ".part" file back for file streams
+	FString HashWrittenBlob() const;
+
+	// Called with WriterLock held - the first value seen for the attempt wins
+	void SetContentEncoding(const FString& ContentEncoding);
+	void ResolveContentEncoding();
+
+	bool bIsFileStream = false;
+	FString TargetPath;
+	FString PartPath;
+
+	// Written from the HTTP thread, read from the game thread
+	std::atomic<int64> BytesReceived;
+
+	FCriticalSection WriterLock;
+	TUniquePtr<FArchive> FileWriter;
+	TArray<uint8> Body;
+
+	bool bDecodeContent = false;
+	// Per attempt - bytes are only inflated once the response said Content-Encoding: gzip/deflate
+	bool bIsEncodingKnown = false;
+	bool bIsEncoded = false;
+	TWeakPtr<IHttpRequest, ESPMode::ThreadSafe> DecodingRequest;
+	bool bIsSniffed = false;
+	// The first chunk may be shorter than the sniffed header
+	TArray<uint8> SniffBuffer;
+	TUniquePtr<FHTTPContentDecoder> Decoder;
+
+	// Guarded by WriterLock as well
+	TUniquePtr<FHTTPStreamHasher> Hasher;
+	// GitBlobSHA1 without a known size - nothing is hashed until VerifyHash()
+	bool bIsHashDeferred = false;
+	FString ExpectedHash;
+	FString ComputedHash;
+};
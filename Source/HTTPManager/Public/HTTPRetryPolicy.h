@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+// HTTP Interfaces
+#include "Interfaces/IHttpResponse.h"
+
+// When and how often a failed request is sent again - shared by every request going through FHTTPRequestQueue;
+// --> Connection errors, 5xx and 429 are retried with exponential backoff and jitter;
+// --> Retry-After and exhausted X-RateLimit-Remaining/X-RateLimit-Reset replace the backoff with the wait the server asked for;
+// --> Deadline - budget of the retry schedule from enqueueing, a backoff retry that would start past it is not made;
+//     Transfers in flight and waits for a rate limit reset are never cut by it - a cancellation token deadline caps those;
+struct HTTPMANAGER_API FHTTPRetryPolicy
+{
+	// Including the first one
+	int32 MaxAttempts = 4;
+
+	float BaseDelay = 1.0f;
+	float MaxDelay = 30.0f;
+
+	// Seconds - 0 means no deadline
+	float Deadline = 0.0f;
+
+	static FHTTPRetryPolicy NoRetry();
+
+	// Seconds to wait before the next attempt - negative if the outcome is final
+	// --> AttemptsMade - attempts sent so far, including the one that produced the response;
+	double GetRetryDelay(int32 AttemptsMade, const FHttpResponsePtr& Response, bool bWasSuccessful) const;
+
+	// Seconds until the server accepts requests again - 0 if the response doesn't ask to wait
+	static double GetRateLimitWait(const FHttpResponsePtr& Response);
+
+	static bool IsTransientError(int32 ResponseCode);
+};
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "HTTPCancellationToken.h"
+#include "HTTPRequestPriority.h"
+// HTTP Interfaces
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+class IFileHandle;
+struct FHTTPRequestOptions;
+
+enum class EHTTPSegmentedResult : uint8
+{
+	Succeeded,
+	Failed,
+	// The server doesn't support byte ranges or the file is below the threshold - download it in one piece instead
+	Unsupported
+};
+
+using FHTTPSegmentedCompleteFunc = TFunction<void(EHTTPSegmentedResult Result, int64 BytesWritten)>;
+
+struct FHTTPSegmentedSettings
+{
+	int32 SegmentCount = 4;
+
+	// Files below this size aren't worth the extra HEAD round trip and range bookkeeping
+	int64 MinSegmentedSize = 8 * 1024 * 1024;
+
+	// How often the per-segment progress is flushed into the sidecar
+	float ProgressSaveInterval = 1.0f;
+
+	// Applies to the probe and every segment
+	EHTTPRequestPriority Priority = EHTTPRequestPriority::Normal;
+
+	// Optional parent - the download runs under a child token of it
+	TSharedPtr<FHTTPCancellationToken> CancellationToken;
+};
+
+// Downloads a single file as N concurrent byte ranges written straight into a preallocated "<Target>.part" file;
+// --> HEAD probe first - Accept-Ranges/Content-Length decide whether the file gets split at all;
+// --> Progress of every segment is saved to "<Target>.part.json", a new download of the same URL resumes from there
+//     as long as the size and ETag/Last-Modified still match;
+// --> An interrupted segment keeps what it received - its retry and any later resume request only the missing tail;
+// Game thread only, except for the segment writes which come from the HTTP thread;
+class HTTPMANAGER_API FHTTPSegmentedDownload : public TSharedFromThis<FHTTPSegmentedDownload, ESPMode::ThreadSafe>
+{
+	public:
+
+	static TSharedRef<FHTTPSegmentedDownload, ESPMode::ThreadSafe> Create(const FString& URL, const FString& TargetPath, const FHTTPSegmentedSettings& Settings);
+
+	~FHTTPSegmentedDownload();
+
+	// Sends the probe - returns its request ID
+	int32 Start(FHTTPSegmentedCompleteFunc InOnComplete);
+
+	// Cancels the probe and every segment in flight - finishes as Failed, progress is kept for resuming
+	void Cancel();
+
+	int64 GetBytesReceived() const;
+	int64 GetTotalSize() const { return TotalSize; }
+	const FString& GetTargetPath() const { return TargetPath; }
+
+	// Called by the segment streams on the HTTP thread
+	// --> Offset - file offset the first byte of Data belongs to, bytes that don't continue the segment are refused;
+	bool WriteSegmentChunk(int32 SegmentIndex, int64 Offset, const void* Data, int64 Num);
+
+	private:
+
+	struct FSegment
+	{
+		int64 Start = 0;
+		// Inclusive, as in the Range header
+		int64 End = 0;
+		// Only bytes of a 206 answering the requested range ever count - a failed attempt keeps them
+		int64 Written = 0;
+		bool bIsInFlight = false;
+
+		int64 GetLength() const { return End - Start + 1; }
+		bool IsDone() const { return Written >= GetLength(); }
+	};
+
+	FHTTPSegmentedDownload() = default;
+
+	void OnProbeComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	void StartSegment(int32 SegmentIndex);
+	// Offset the next attempt of the segment starts at - INDEX_NONE once there's nothing left to request
+	int64 PrepareSegmentRequest(int32 SegmentIndex, FString& OutRange);
+	void OnSegmentComplete(int32 SegmentIndex, FHttpResponsePtr Response, bool bWasSuccessful);
+	FHTTPRequestOptions MakeRequestOptions(const FString& Verb) const;
+
+	void BuildSegments();
+	bool OpenPartFile(bool bResume);
+	bool LoadSidecar();
+	void SaveSidecar();
+	void Finish(EHTTPSegmentedResult Result);
+
+	FString URL;
+	FString TargetPath;
+	FString PartPath;
+	FString SidecarPath;
+	FHTTPSegmentedSettings Settings;
+
+	int64 TotalSize = 0;
+	// ETag or Last-Modified - a changed resource never resumes into a stale part file
+	FString Validator;
+
+	// Shared by the probe and all segments
+	TSharedPtr<FHTTPCancellationToken> CancellationToken;
+
+	// Guarded by FileLock - written from the HTTP thread
+	mutable FCriticalSection FileLock;
+	TArray<FSegment> Segments;
+	TUniquePtr<IFileHandle> FileHandle;
+
+	int32 NumInFlight = 0;
+	bool bHasFailed = false;
+	bool bIsFinished = false;
+
+	FTSTicker::FDelegateHandle SaveTickerHandle;
+	FHTTPSegmentedCompleteFunc OnComplete;
+};
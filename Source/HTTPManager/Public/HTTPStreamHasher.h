@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+#include "HTTPStreamHasher.generated.h"
+
+// Digest computed over a body while it streams in
+UENUM(BlueprintType)
+enum class EHTTPHashAlgorithm : uint8
+{
+	None,
+	// Same as the manifest hashes of CalculateFileHash_UTIL
+	MD5,
+	SHA1,
+	SHA256,
+	// SHA-1 of "blob <size>\0" + content - the "sha" GitHub reports for every file, needs the size up front
+	GitBlobSHA1
+};
+
+// Incremental SHA-256 (FIPS 180-4) - Core only ships MD5 and SHA-1;
+// --> The module has no automation tests - after touching it, check the FIPS 180-4 vectors by hand, e.g. "abc" -> ba7816bf...f20015ad, "" -> e3b0c442...7852b855;
+class HTTPMANAGER_API FHTTPSHA256
+{
+	public:
+
+	static constexpr int32 DigestSize = 32;
+
+	FHTTPSHA256() { Reset(); }
+
+	void Reset();
+	void Update(const uint8* Data, int64 Num);
+	void Final(uint8* OutDigest);
+
+	private:
+
+	void Transform(const uint8* Block);
+
+	uint32 State[8];
+	uint64 TotalBytes = 0;
+	uint8 Block[64];
+	int32 BlockSize = 0;
+};
+
+// Feeds the bytes of a download into one of EHTTPHashAlgorithm as they arrive - no second read of the file to verify it;
+// Not thread-safe - FHTTPResponseStream calls it under its writer lock;
+class HTTPMANAGER_API FHTTPStreamHasher
+{
+	public:
+
+	// BlobSize - content size for GitBlobSHA1, ignored otherwise
+	explicit FHTTPStreamHasher(EHTTPHashAlgorithm InAlgorithm, int64 InBlobSize = 0);
+
+	// Starts over - a retried download hashes its body from the first byte again
+	void Reset();
+
+	void Update(const uint8* Data, int64 Num);
+
+	// Lowercase hex, like GitHub and the manifest - the hasher has to be Reset() before it's fed again
+	FString Finalize();
+
+	// Case-insensitive - an empty expected hash always matches
+	static bool Matches(const FString& ComputedHash, const FString& ExpectedHash);
+
+	EHTTPHashAlgorithm GetAlgorithm() const { return Algorithm; }
+
+	private:
+
+	EHTTPHashAlgorithm Algorithm = EHTTPHashAlgorithm::None;
+	int64 BlobSize = 0;
+
+	FMD5 MD5;
+	FSHA1 SHA1;
+	FHTTPSHA256 SHA256;
+};
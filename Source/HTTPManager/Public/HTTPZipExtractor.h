@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FHTTPZipMemoryStream;
+
+// Extracts a subtree of an in-memory archive - no temp file for the archive itself;
+// --> mz_zip_reader walks the central directory and filters entries through mz_zip_reader_set_pattern;
+// --> Entry data is inflated straight from the memory buffer - the vendored minizip is built without mz_strm_zlib/mz_strm_os,
+//     so mz_zip_reader_entry_save/mz_zip_reader_save_all can't decompress or write files here;
+class HTTPMANAGER_API FHTTPZipExtractor
+{
+	public:
+
+	// Extracts every file under Prefix (e.g. "Macros/") into DestinationDir, with the prefix stripped from the paths;
+	// --> bHasRootFolder - GitHub zipballs wrap everything into "<owner>-<repo>-<sha>/", which is skipped when matching the prefix;
+	// --> OutFiles - absolute paths of the written files;
+	static bool ExtractPrefix(const FHTTPZipMemoryStream& Archive, const FString& Prefix, const FString& DestinationDir, bool bHasRootFolder, TArray<FString>& OutFiles);
+
+	// Inflates a single entry given its central directory data - shared with the streaming extractor
+	static bool InflateEntry(uint16 CompressionMethod, const uint8* Data, int64 CompressedSize, int64 UncompressedSize, uint32 ExpectedCrc, TArray<uint8>& OutData);
+
+	// "<root>/Macros/YouTube/a.csv" -> "YouTube/a.csv" - false for entries outside the prefix or with unsafe paths
+	static bool MapEntryPath(const FString& EntryName, const FString& Prefix, bool bHasRootFolder, FString& OutRelativePath);
+
+	// Rejects absolute paths and ".." components - an archive must never write outside DestinationDir
+	static bool IsSafeRelativePath(const FString& RelativePath);
+};
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Owns a downloaded archive and exposes it to minizip as a read-only mz_stream_mem;
+// --> The response buffer is moved in and handed over through mz_stream_mem_set_buffer - no copy on the way from the socket to the zip reader;
+// --> The stream must not outlive this object, minizip reads straight from Buffer;
+class HTTPMANAGER_API FHTTPZipMemoryStream
+{
+	public:
+
+	explicit FHTTPZipMemoryStream(TArray<uint8>&& InBuffer);
+	~FHTTPZipMemoryStream();
+
+	FHTTPZipMemoryStream(const FHTTPZipMemoryStream&) = delete;
+	FHTTPZipMemoryStream& operator=(const FHTTPZipMemoryStream&) = delete;
+
+	bool IsValid() const { return MemStream != nullptr; }
+
+	// Pass to mz_zip_reader_open / mz_zip_open
+	void* GetStream() const { return MemStream; }
+
+	const TArray<uint8>& GetBuffer() const { return Buffer; }
+
+	private:
+
+	TArray<uint8> Buffer;
+	void* MemStream = nullptr;
+};
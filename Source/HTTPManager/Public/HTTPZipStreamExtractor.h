@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+#include "HTTPContentDecoder.h"
+
+#include <atomic>
+
+// Forward-only unzip handed over to IHttpRequest::SetResponseBodyReceiveStream - entries are extracted while the archive is still downloading;
+// --> Walks local file headers and data descriptors in order, the central directory at the end of the archive is never needed;
+// --> Entries whose sizes only follow in the data descriptor have to be deflated - a deflate stream ends by itself, stored data doesn't;
+// --> Every file goes to "<file>.part" first and is verified against its CRC-32 and size;
+// --> The verified files are only moved into place by Finish, once the whole archive arrived - a cut-off download never leaves the folder half updated;
+// Serialize runs on the HTTP thread, the rest on the game thread;
+class HTTPMANAGER_API FHTTPZipStreamExtractor : public FArchive
+{
+	public:
+
+	// Same filtering as FHTTPZipExtractor::ExtractPrefix
+	static TSharedRef<FHTTPZipStreamExtractor> Create(const FString& Prefix, const FString& DestinationDir, bool bHasRootFolder);
+
+	virtual ~FHTTPZipStreamExtractor();
+
+	// Drops the parser state and the staged files of a previous attempt
+	void Restart();
+
+	// Call once the request completed - moves the staged files into place if the archive was read up to its central directory without errors;
+	// Otherwise the staged files are deleted and the destination is left as it was
+	bool Finish(TArray<FString>& OutFiles);
+
+	int64 GetBytesReceived() const { return BytesReceived.load(); }
+
+	// FArchive interface
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual int64 Tell() override { return BytesReceived.load(); }
+	virtual int64 TotalSize() override { return BytesReceived.load(); }
+	virtual FString GetArchiveName() const override { return TEXT("FHTTPZipStreamExtractor"); }
+
+	private:
+
+	enum class EState : uint8
+	{
+		Signature,
+		LocalHeader,
+		EntryName,
+		EntryData,
+		Descriptor,
+		Done
+	};
+
+	struct FEntry
+	{
+		FString Name;
+		uint16 Flag = 0;
+		uint16 Method = 0;
+		uint32 Crc = 0;
+		int64 CompressedSize = 0;
+		int64 UncompressedSize = 0;
+		uint16 NameSize = 0;
+		uint16 ExtraSize = 0;
+
+		bool bHasDescriptor = false;
+		bool bIsZip64 = false;
+		// False if only the data descriptor knows where the data ends
+		bool bIsSizeKnown = true;
+
+		int64 CompressedConsumed = 0;
+		int64 Written = 0;
+		uint32 RunningCrc = 0;
+
+		// Empty for entries outside the prefix - their data is skipped
+		FString TargetPath;
+		TUniquePtr<FArchive> Writer;
+		TUniquePtr<FHTTPContentDecoder> Decoder;
+	};
+
+	FHTTPZipStreamExtractor();
+
+	// All called with Lock held
+	void Consume(const uint8* Data, int64 Num);
+	bool Gather(const uint8*& Data, int64& Num, int32 Needed);
+	bool ParseLocalHeader();
+	bool BeginEntry();
+	int64 ConsumeEntryData(const uint8* Data, int64 Num);
+	bool WriteEntryData(const uint8* Data, int64 Num);
+	void EndEntryData();
+	bool ParseDescriptor();
+	bool FinishEntry(uint32 ExpectedCrc, int64 ExpectedSize);
+	void AbortEntry();
+	void DiscardStagedFiles();
+	void Fail(const FString& Reason);
+
+	FString Prefix;
+	FString DestinationDir;
+	bool bHasRootFolder = true;
+
+	FCriticalSection Lock;
+	EState State = EState::Signature;
+	// Header bytes split across body chunks
+	TArray<uint8> HeaderBuffer;
+	int32 DescriptorSize = 0;
+
+	FEntry Entry;
+	// Target paths of the verified entries - their data waits in "<target>.part" until Finish
+	TArray<FString> StagedFiles;
+
+	std::atomic<int64> BytesReceived;
+};
@@ -13,9 +13,119 @@
 // JSON
 #include "Json.h"
 #include "JsonUtilities.h"
+// HTTP Manager
+#include "HTTPCancellationToken.h"
+#include "HTTPRequestQueue.h"
 
 #include "MacrosManager.generated.h"
 
+// One blob of the remote tree - filled by FetchTree_SYNC
+USTRUCT(BlueprintType)
+struct FMacrosRemoteFile
+{
+	GENERATED_BODY()
+
+	// Below the synced prefix - also the path below the local folder
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	FString Path;
+
+	// Git blob SHA-1 - changes with the content only
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	FString Sha;
+
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	int64 Size = 0;
+};
+
+// Answer of a sync status check - filled by UMacrosSyncStatusAction
+USTRUCT(BlueprintType)
+struct FMacrosSyncStatus
+{
+	GENERATED_BODY()
+
+	// The last commit is more than two minutes newer than the local folder
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	bool bIsSyncNeeded = false;
+
+	// Both in local time
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	FDateTime LocalTimeStamp;
+
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	FDateTime RemoteTimeStamp;
+
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	FString RemoteCommitSha;
+
+	// 0 if the request never got an answer
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	int32 ResponseCode = 0;
+
+	// -1 if GitHub didn't report it
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	int32 RateLimitRemaining = -1;
+
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	FDateTime RateLimitResetAt;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnCrawlFinished, bool, bWasSuccessful, const TArray<FString>&, FileList);
+
+// Work list of one contents crawl - touched on the game thread only
+struct FMacrosCrawlState
+{
+	// Breadth-first - directories wait here until a crawl slot is free
+	TArray<FString> PendingURLs;
+	// Every directory URL ever queued - a directory reachable twice is fetched once
+	TSet<FString> VisitedURLs;
+	TArray<FString> FileList;
+	int32 InFlight = 0;
+	int32 NumFailed = 0;
+	bool bIsFinished = false;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRemoteTreeFetched, bool, bWasSuccessful, int32, NumFiles);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnDeltaSyncFinished, bool, bWasSuccessful, int32, NumDownloaded, int32, NumDeleted);
+
+// Entry of the local blob index - the SHA is only recomputed once size or timestamp of the file changed
+struct FMacrosLocalBlob
+{
+	FString Sha;
+	int64 Size = 0;
+	FDateTime TimeStamp;
+};
+
+// Shared by the downloads of one delta sync
+struct FMacrosDeltaSyncState
+{
+	FString LocalFolderPath;
+	// Relative path -> blob, written back to the index file once the sync is done
+	TMap<FString, FMacrosLocalBlob> Index;
+	TArray<FString> RemovedPaths;
+	int32 Remaining = 0;
+	int32 NumDownloaded = 0;
+	int32 NumFailed = 0;
+	// Recorded as the RSSInit watermark once every download succeeded - empty for syncs not tied to a commit
+	FString CommitSha;
+	// The sync the downloads belong to - a failed one leaves the indicator alone once a newer sync took over
+	TSharedPtr<FHTTPCancellationToken> SyncToken;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnRemoteChangesChecked, bool, bWasSuccessful, bool, bIsSyncNeeded, int32, NumChangedFiles);
+
+// Changes below the synced prefix between the RSSInit watermark and the head commit
+struct FMacrosCommitDiff
+{
+	FString BaseSha;
+	FString HeadSha;
+	// Size is unknown here (INDEX_NONE) - the compare endpoint only reports blob SHAs
+	TArray<FMacrosRemoteFile> ChangedFiles;
+	TArray<FString> RemovedPaths;
+	// False without a watermark, after a force-push or for diffs GitHub cuts off - only a full tree sync is exact then
+	bool bIsComplete = false;
+};
+
 // UENUM(BlueprintType)
 // enum EMacroCategory
 // {
@@ -118,13 +228,82 @@ class UMacrosManager : public UEditorUtilityWidget
 	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary")
 	void ScrollBackward(FString &OutContent);
 
+	// Crawls the contents API directory by directory - at most MaxCrawlConcurrency listings are requested at a time;
+	// --> Fires OnCrawlFinished once, with every file path found, after the last directory was listed or the crawl was cancelled;
 	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary")
 	void FetchFilesRecursive_SYNC(FString FullURLPath);
 
+	// Directory listings of one crawl requested at the same time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MacrosManagerLibrary", meta = (ClampMin = "1"))
+	int32 MaxCrawlConcurrency = 4;
+
+	// Result of the last FetchFilesRecursive_SYNC - repository paths, sorted
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	TArray<FString> CrawledFiles;
+
+	UPROPERTY(BlueprintAssignable, Category = "MacrosManagerLibrary")
+	FOnCrawlFinished OnCrawlFinished;
+
+	// Lists the whole remote tree with a single request instead of one contents request per directory;
+	// --> TreeURL - e.g. https://api.github.com/repos/<owner>/<repo>/git/trees/<branch or sha>?recursive=1;
+	// --> PathPrefix - only blobs below it are kept, with the prefix stripped like the zipball extraction does;
+	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary")
+	void FetchTree_SYNC(FString TreeURL, FString PathPrefix = TEXT("Macros/"));
+
+	// Result of the last FetchTree_SYNC - blob SHAs and sizes of every remote file
+	UPROPERTY(BlueprintReadOnly, Category = "MacrosManagerLibrary")
+	TArray<FMacrosRemoteFile> RemoteFiles;
+
+	UPROPERTY(BlueprintAssignable, Category = "MacrosManagerLibrary")
+	FOnRemoteTreeFetched OnRemoteTreeFetched;
+
+	// Downloads only the files whose git blob SHA differs from the remote tree, then deletes the files removed remotely;
+	// --> TreeURL - as for FetchTree_SYNC, the blobs are fetched from git/blobs/<sha> of the same repository and verified against their SHA;
+	// --> The local SHAs are cached in Saved/MacrosManager/BlobIndex.json and only recomputed for files whose size or timestamp changed;
+	// --> Local changes to synced files are overwritten - the remote tree wins;
+	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary")
+	void DeltaSync_SYNC(FString TreeURL, FString LocalFolderPath, FString PathPrefix = TEXT("Macros/"));
+
+	UPROPERTY(BlueprintAssignable, Category = "MacrosManagerLibrary")
+	FOnDeltaSyncFinished OnDeltaSyncFinished;
+
+	// Syncs exactly the files changed since the commit recorded in RSSInit - one compare request instead of a tree walk;
+	// --> RepositoryURL - e.g. https://api.github.com/repos/<owner>/<repo>;
+	// --> Branch - resolved to its head commit, which becomes the new watermark once every file is synced;
+	// --> Without a watermark, after a force-push or for very large diffs it falls back to DeltaSync_SYNC on the head commit;
+	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary")
+	void SyncSinceLastCommit_SYNC(FString RepositoryURL, FString LocalFolderPath, FString Branch = TEXT("HEAD"), FString PathPrefix = TEXT("Macros/"));
+
+	// Asks whether the branch changed anything below PathPrefix since the watermark - updates SyncImage and RSSInit, downloads nothing
+	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary")
+	void CheckRemoteChanges_SYNC(FString RepositoryURL, FString Branch = TEXT("HEAD"), FString PathPrefix = TEXT("Macros/"));
+
+	UPROPERTY(BlueprintAssignable, Category = "MacrosManagerLibrary")
+	FOnRemoteChangesChecked OnRemoteChangesChecked;
+
+	// Downloads the repository zipball in a single request and extracts its Macros/ folder into LocalFolderPath;
+	// --> ZipballURL - e.g. https://api.github.com/repos/<owner>/<repo>/zipball/<branch>;
+	// --> bExtractWhileDownloading - files are written as their entries arrive, otherwise the archive is buffered and extracted at the end;
+	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary")
+	void SyncMacrosFromZipball(FString ZipballURL, FString LocalFolderPath, bool bExtractWhileDownloading = true);
+
+	// Stops the running crawl or zipball sync - requests already in flight are cancelled as well
+	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary")
+	void CancelSync();
+
+	// Seconds a whole sync may take, every request it spawns included - 0 disables
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MacrosManagerLibrary", meta = (ClampMin = "0"))
+	float SyncTimeout = 600.0f;
+
+	// How often a running zipball sync refreshes its progress in CustomLog_TXT and SyncImage
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MacrosManagerLibrary", meta = (ClampMin = "16"))
+	int32 SyncProgressIntervalMs = 250;
+
 	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary")
 	FDateTime CheckLocalChanges(FString LocalFolderPath);
 
-	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary", meta = (ExpandBoolAsExecs = "bIsSyncNeeded"))
+	// The answer arrives after the node returned - bIsSyncNeeded is always false, the result only shows in SyncImage and CustomLog_TXT
+	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary", meta = (ExpandBoolAsExecs = "bIsSyncNeeded", DeprecatedFunction, DeprecationMessage = "Use Check Sync Status - its pins fire once GitHub answered."))
 	void GetLastModifiedFromGitHub(FString RepositoryURL, FString LocalFolderPath, bool &bIsSyncNeeded);
 
 	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary", meta = (ExpandBoolAsExecs = "bIsSyncNeeded"))
@@ -146,6 +325,8 @@ class UMacrosManager : public UEditorUtilityWidget
 
 	private:
 
+	friend class UMacrosSyncStatusAction;
+
 	// Utilities
 	TArray<FString> MacrosArray;
 	TArray<FString> MacrossArray_FullPath;
@@ -160,4 +341,58 @@ class UMacrosManager : public UEditorUtilityWidget
 	FString ReflectFileToScreen_UTIL(int32 CurrentIndex);
 	void CustomLog_FText_UTIL(FString FunctionName, FString LogText);
 	void HandleThisLifycycle();
+	void FinishZipballSync_UTIL(bool bIsSucceeded, int32 NumFiles, TSharedRef<FHTTPCancellationToken> SyncToken);
+	void FetchFilesRecursive_UTIL(FString FullURLPath, TSharedRef<FMacrosCrawlState> State, TSharedRef<FHTTPCancellationToken> CrawlToken);
+	void PumpCrawl_UTIL(TSharedRef<FMacrosCrawlState> State, TSharedRef<FHTTPCancellationToken> CrawlToken);
+	void FetchTree_UTIL(FString TreeURL, FString PathPrefix, TSharedRef<FHTTPCancellationToken> SyncToken, TFunction<void(bool bIsFetched)> OnFetched);
+	static bool ParseTree_UTIL(const FString& ResponseStr, const FString& PathPrefix, TArray<FMacrosRemoteFile>& OutFiles);
+
+	// Delta sync - the local scan and the index file run on workers, every download commits on a worker as well
+	void DeltaSync_UTIL(FString TreeURL, FString LocalFolderPath, FString PathPrefix, FString CommitSha, TSharedRef<FHTTPCancellationToken> SyncToken);
+	void PlanDeltaSync_UTIL(FString BlobsURL, FString LocalFolderPath, FString CommitSha, TSharedRef<FHTTPCancellationToken> SyncToken);
+	void StartDeltaDownloads_UTIL(FString BlobsURL, TArray<FMacrosRemoteFile> ChangedFiles, TSharedRef<FMacrosDeltaSyncState> State, TSharedRef<FHTTPCancellationToken> SyncToken);
+	void FinishDeltaSync_UTIL(TSharedRef<FMacrosDeltaSyncState> State);
+	void FailDeltaSync_UTIL(FString FunctionName, FString LogText, TSharedRef<FHTTPCancellationToken> SyncToken);
+	bool OwnsSyncIndicator_UTIL(const FHTTPCancellationToken& SyncToken) const;
+	static TMap<FString, FMacrosLocalBlob> LoadBlobIndex_UTIL(const FString& LocalFolderPath);
+	static TMap<FString, FMacrosLocalBlob> ScanLocalBlobs_UTIL(const FString& LocalFolderPath);
+	static void SaveBlobIndex_UTIL(const FString& LocalFolderPath, const TMap<FString, FMacrosLocalBlob>& Index);
+
+	// Commit watermark - the head is resolved with a tiny SHA-only request, the compare request is only sent once it moved
+	void CompareWithWatermark_UTIL(FString RepositoryURL, FString Branch, FString PathPrefix, TSharedRef<FHTTPCancellationToken> SyncToken, TFunction<void(bool bIsCompared, TSharedRef<FMacrosCommitDiff> CommitDiff)> OnCompared);
+	void CompareCommits_UTIL(FString RepositoryURL, TSharedRef<FMacrosCommitDiff> Diff, FString PathPrefix, TSharedRef<FHTTPCancellationToken> SyncToken, TFunction<void(bool bIsCompared, TSharedRef<FMacrosCommitDiff> CommitDiff)> OnCompared);
+	static bool ParseCompare_UTIL(const FString& ResponseStr, const FString& PathPrefix, FMacrosCommitDiff& OutDiff);
+	static void ReadSyncedCommitSha_UTIL(TFunction<void(FString SyncedCommitSha)> OnRead);
+
+	// Compares the last commit of RepositoryURL with the local timestamp - OnChecked runs on the game thread exactly once, even if the widget is gone
+	void CheckSyncStatus_UTIL(FString RepositoryURL, FString LocalFolderPath, TFunction<void(bool bIsChecked, const FMacrosSyncStatus& Status)> OnChecked);
+
+	// Worker-safe helpers - RSSInit updates are serialized on a task pipe
+	static void UpdateRSSInit_UTIL(FString FunctionName, TFunction<void(FJsonObject&)> Update);
+	static void ReadRSSInit_UTIL(FString FunctionName, TFunction<void(TSharedPtr<FJsonObject> RSSMacrosManager)> OnRead);
+	static FDateTime GetLocalTimeStamp_UTIL(const FString& LocalFolderPath);
+
+	// Every request of the widget runs under RequestsToken - cancelled in NativeDestruct;
+	// --> SyncCancellationToken - child shared by all requests of the running sync;
+	TSharedRef<FHTTPCancellationToken> GetRequestsToken_UTIL();
+	TSharedRef<FHTTPCancellationToken> StartSync_UTIL();
+	TSharedPtr<FHTTPCancellationToken> RequestsToken;
+	TSharedPtr<FHTTPCancellationToken> SyncCancellationToken;
+
+	// Polls the queue for the download of the running sync - stops once the request left the queue
+	void TrackSyncProgress_UTIL(int32 RequestId);
+	bool TickSyncProgress_UTIL(int32 RequestId);
+	FTSTicker::FDelegateHandle SyncProgressTickerHandle;
+	FHTTPProgressSample SyncProgress;
+
+	// Shared rate limit budget - seeded from RSSInit and written back once GitHub reported a new count, debounced by a ticker
+	void OnRateLimitUpdated(const FString& Host, int32 Remaining, int64 ResetAt);
+	void SaveRateLimit_UTIL();
+	FString RateLimitHost;
+	FDelegateHandle RateLimitUpdatedHandle;
+	FTSTicker::FDelegateHandle RateLimitSaveTickerHandle;
+	int32 PendingRateLimit = -1;
+	int64 PendingRateLimitResetAt = 0;
+	int32 SavedRateLimit = -1;
+	int64 SavedRateLimitResetAt = 0;
 };
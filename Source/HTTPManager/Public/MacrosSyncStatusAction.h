@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "MacrosManager.h"
+
+#include "MacrosSyncStatusAction.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMacrosSyncStatus, const FMacrosSyncStatus&, Status);
+
+// Async node around UMacrosManager's commit check - exactly one of its pins fires once GitHub answered;
+// --> The widget can chain the sync right off OnSyncNeeded instead of polling SyncImage or RSSInit;
+// --> The action keeps itself alive until the answer arrives - editor utility widgets have no game instance to register with;
+UCLASS()
+class UMacrosSyncStatusAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+	public:
+
+	// RepositoryURL - the commits endpoint, e.g. https://api.github.com/repos/<owner>/<repo>/commits?path=Macros
+	UFUNCTION(BlueprintCallable, Category = "MacrosManagerLibrary", meta = (BlueprintInternalUseOnly = "true", DisplayName = "Check Sync Status"))
+	static UMacrosSyncStatusAction* CheckSyncStatus(UMacrosManager* InMacrosManager, FString InRepositoryURL, FString InLocalFolderPath);
+
+	UPROPERTY(BlueprintAssignable, Category = "MacrosManagerLibrary")
+	FOnMacrosSyncStatus OnSyncNeeded;
+
+	UPROPERTY(BlueprintAssignable, Category = "MacrosManagerLibrary")
+	FOnMacrosSyncStatus OnUpToDate;
+
+	// The request failed or the widget was closed meanwhile - Status still carries the response code and rate limit, if any
+	UPROPERTY(BlueprintAssignable, Category = "MacrosManagerLibrary")
+	FOnMacrosSyncStatus OnFailed;
+
+	virtual void Activate() override;
+
+	private:
+
+	void Finish_UTIL(bool bIsChecked, const FMacrosSyncStatus& Status);
+
+	TWeakObjectPtr<UMacrosManager> MacrosManager;
+	FString RepositoryURL;
+	FString LocalFolderPath;
+};